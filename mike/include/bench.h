@@ -1,5 +1,7 @@
 #pragma once
 #include "card.h"
+#include "rng.h"
+#include "stats.h"
 #include <vector>
 #include <map>
 #include <any>
@@ -13,9 +15,23 @@ namespace Poker {
 
   std::tuple<double,double> monteCarloSingleHand(const std::vector<Card>& cardsA, const int numCommCards, const int numOtherPlayers, const uint64_t N);
   std::tuple<double,double> monteCarloSingleHand(const std::vector<Card>& cardsA, const std::vector<Card>& commCards, const int numOtherPlayers, const uint64_t N);
+  std::tuple<double,double> monteCarloSingleHand(const CardSet& cardsA, const CardSet& commCards, const int numOtherPlayers, const uint64_t N, Rng& rng = threadRng());
   void monteCarloGameStateCompare();
 
   std::tuple<double, double> monteCarloRounds(const uint64_t& N, const std::multimap<std::string, std::vector<std::any>>& aiInfo);
   std::tuple<double, double> monteCarloGames(const uint64_t& N, const std::multimap<std::string, std::vector<std::any>>& aiInfo);
+
+  struct DuplicateResult {
+    // One entry per candidate parameter set for player 0, in the order given.
+    // winnings: player 0's result per deal, averaged over every seat rotation
+    // difference: paired against candidate 0 on the same deals, so its standard error excludes card luck
+    std::vector<RunningStats> winnings;
+    std::vector<RunningStats> difference;
+  };
+  // Duplicate evaluation: every deal is replayed with the seats rotated through every position and with each
+  // candidate's parameters given to player 0, on the same cards and the same random choices.
+  // Rounds report winnings in big blinds, games report the fraction won
+  DuplicateResult monteCarloDuplicateRounds(const uint64_t& N, const std::vector<std::vector<std::any>>& candidates, const std::multimap<std::string, std::vector<std::any>>& aiInfo);
+  DuplicateResult monteCarloDuplicateGames(const uint64_t& N, const std::vector<std::vector<std::any>>& candidates, const std::multimap<std::string, std::vector<std::any>>& aiInfo);
   void monteCarloRandomHand(const int numCommCards, const int numOtherPlayers, const uint64_t numHands, const uint64_t numHandMC, std::string outFileName, int numThreads);
 }
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "headsup.h"
+#include "strategy.h"
+
+namespace Poker {
+    class MCCFRTrainer;
+
+    struct Exploitability {
+        double bestResponse[2];         // chips per hand a best response in each seat wins against the policy
+        double chipsPerHand;            // their mean: zero exactly when the policy is an equilibrium
+        double mbbPerHand;              // the same in thousandths of a big blind
+    };
+
+    class BestResponse {
+        // Best response to a CFRAI1 policy playing both seats of the HeadsUpState game.
+        // The responder knows its own cards and the public history; the policy sees only its ReducedGameState.
+        // The walk is over public states carrying one entry per hole-card pair (1326): the policy's reach for each of
+        // its hands going down, and the responder's value for each of its hands coming back. Terminal values are
+        // computed for all hands at once against the opponent's range, with card removal.
+        // Boards come from a fixed sample of flops, turns per flop and rivers per turn drawn from seed, so the answer
+        // is the exact best response in that sampled chance tree and is the same for a given seed on any number of
+        // threads. Flop subtrees are walked in parallel on the shared pool
+        public:
+            struct Settings : HeadsUpSettings {
+                int flops = 16;
+                int turnsPerFlop = 2;
+                int riversPerTurn = 2;
+                uint64_t seed = 1;
+                std::shared_ptr<const HandBuckets> buckets;     // the card abstraction the policy was trained with
+            };
+            using Policy = std::function<std::array<float, CFRAI1::kNumBinnedMoves>(CFRAI1::InfosetKey)>;    // weights, normalized over the legal actions
+
+            static Policy policyOf(const CFRAI1& ai);               // its policy file, then its table, else uniform
+            static Policy policyOf(const MCCFRTrainer& trainer);    // the trainer's average strategy
+
+            BestResponse() : BestResponse(Settings()) {}
+            explicit BestResponse(const Settings& settings);
+            ~BestResponse();
+
+            double value(const Policy& policy, const int seat) const;      // chips per hand for a best response in seat
+            Exploitability exploitability(const Policy& policy) const;
+
+        private:
+            struct BoardNode;
+            class Walk;
+            Settings settings;
+            std::unique_ptr<BoardNode> root;        // the sampled chance tree, built once
+    };
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
 #include <unordered_map>
 #include <random>
@@ -86,66 +89,167 @@ namespace Poker {
         return stream;
     }
 
+    // Cards are numbered 16*suit + rank, so each suit owns one 16-bit lane of a 64-bit mask
+    // and the 13-bit rank mask of a suit is a shift away
+    constexpr int kCardIndexLimit = 64;
 
-    class Deck {
-        private:
-            std::mt19937_64 rng;
+    inline int suitToIndex(const Suit s) {
+        // Same suit order as the Deck constructor
+        switch (s) {
+            case Suit::CLUB:    return 0;
+            case Suit::DIAMOND: return 1;
+            case Suit::HEART:   return 2;
+            case Suit::SPADE:   return 3;
+            default:            return -1;
+        }
+    }
+    inline Suit indexToSuit(const int i) {
+        constexpr Suit suits[4] = { Suit::CLUB, Suit::DIAMOND, Suit::HEART, Suit::SPADE };
+        return suits[i & 3];
+    }
+    inline int cardToIndex(const Card& c) {
+        // -1 for undefined cards
+        const int s = suitToIndex(c.get_suit());
+        const int r = c.get_rank_as_int();
+        if( s < 0 or r < 0 ) return -1;
+        return 16 * s + r;
+    }
+    inline Card indexToCard(const int i) { return Card(static_cast<Rank>(i & 15), indexToSuit(i >> 4)); }
+
+    class CardSet {
         public:
-            std::vector<Card> cards;         // array to hold cards
-            Deck() {
-                cards = std::vector<Card>(52);
-                std::random_device rd;
-                rng.seed(rd());
-                constexpr int nRanks = 13;
-                for(int i=0; i<nRanks; i++) {
-                    cards[4*i]  =Card(static_cast<Rank>(i), Suit::CLUB);
-                    cards[4*i+1]=Card(static_cast<Rank>(i), Suit::DIAMOND);
-                    cards[4*i+2]=Card(static_cast<Rank>(i), Suit::HEART);
-                    cards[4*i+3]=Card(static_cast<Rank>(i), Suit::SPADE);
+            uint64_t mask = 0;
+
+            static constexpr uint64_t kFullDeckMask = 0x1fff1fff1fff1fffULL;
+
+            CardSet() = default;
+            constexpr explicit CardSet(uint64_t m) : mask(m) {};
+            CardSet(const Card* cards, const size_t n) { for(size_t i=0; i<n; i++) insert(cards[i]); }
+            CardSet(const std::vector<Card>& cards) : CardSet(cards.data(), cards.size()) {};
+            CardSet(std::initializer_list<Card> cards) { for(const Card& c : cards) insert(c); }
+            static constexpr CardSet fullDeck() { return CardSet(kFullDeckMask); }
+            static constexpr CardSet fromIndex(const int i) { return CardSet(1ULL << i); }
+
+            size_t size() const { return __builtin_popcountll(mask); }
+            bool empty() const { return mask == 0; }
+            void clear() { mask = 0; }
+            bool contains(const Card& c) const { const int i = cardToIndex(c); return i >= 0 and (mask >> i) & 1; }
+            bool contains(const CardSet& other) const { return (mask & other.mask) == other.mask; }
+            bool intersects(const CardSet& other) const { return (mask & other.mask) != 0; }
+            void insert(const Card& c) { const int i = cardToIndex(c); if( i >= 0 ) mask |= 1ULL << i; }
+            void insertIndex(const int i) { mask |= 1ULL << i; }
+            void erase(const Card& c) { const int i = cardToIndex(c); if( i >= 0 ) mask &= ~(1ULL << i); }
+            uint32_t suitMask(const int s) const { return (mask >> (16 * s)) & 0x1fff; }
+            CardSet complement() const { return CardSet(~mask & kFullDeckMask); }
+
+            // Calls f(cardIndex) for every card, lowest index first
+            template<typename F>
+                void forEachIndex(F&& f) const {
+                    for(uint64_t m = mask; m; m &= m - 1)
+                        f(__builtin_ctzll(m));
                 }
+            std::vector<Card> toCards() const {
+                std::vector<Card> out;
+                out.reserve(size());
+                forEachIndex([&out](int i) { out.emplace_back(indexToCard(i)); });
+                return out;
             }
-            void setSeed(uint64_t seed) { rng.seed(seed); }
-            void shuffle() {
-                std::shuffle(cards.begin(), cards.end(), rng);
-            }
-            size_t size() const { return cards.size(); }
-            const Card pop_card() {
-                if( cards.size() == 0 ) return Card(); // error
-                Card ret = cards.back();
-                cards.pop_back();
-                return ret;
+
+            CardSet& operator|=(const CardSet& o) { mask |= o.mask; return *this; }
+            CardSet& operator&=(const CardSet& o) { mask &= o.mask; return *this; }
+            CardSet& operator-=(const CardSet& o) { mask &= ~o.mask; return *this; }
+    };
+    inline CardSet operator|(CardSet a, const CardSet& b) { return a |= b; }
+    inline CardSet operator&(CardSet a, const CardSet& b) { return a &= b; }
+    inline CardSet operator-(CardSet a, const CardSet& b) { return a -= b; }
+    inline bool operator==(const CardSet& a, const CardSet& b) { return a.mask == b.mask; }
+    inline bool operator!=(const CardSet& a, const CardSet& b) { return a.mask != b.mask; }
+
+    inline std::ostream& operator<<(std::ostream& stream, const CardSet& a) {
+        a.forEachIndex([&stream](int i) { Card c = indexToCard(i); stream << c << " "; });
+        return stream;
+    }
+
+
+    template<typename URBG>
+        inline uint32_t boundedRandom(URBG& rng, const uint32_t range) {
+            // Uniform integer in [0, range) from one multiply (Lemire). Rejection keeps it unbiased
+            static_assert(URBG::max() - URBG::min() >= 0xffffffffULL, "generator must produce 32 random bits");
+            uint64_t m = uint64_t(uint32_t(rng())) * range;
+            uint32_t low = uint32_t(m);
+            if( low < range ) {
+                const uint32_t threshold = uint32_t(-range) % range;
+                while( low < threshold ) {
+                    m = uint64_t(uint32_t(rng())) * range;
+                    low = uint32_t(m);
+                }
             }
-            void push_card(const Card& a) {
-                if( cards.size() == 51 ) std::cerr << "Tried to add a card to a full deck." << std::endl; // error
-                cards.emplace_back(a);
+            return uint32_t(m >> 32);
+        }
+
+    class Deck {
+        // Fixed-size deck of card indices that never allocates
+        // The cards still in the deck are cards[dealt, live); dead cards are parked behind 'live'.
+        // Dealing is a partial Fisher-Yates shuffle, so only the cards actually dealt cost a random number
+        private:
+            std::array<uint8_t, 52> cards;                  // a permutation of all 52 card indices
+            std::array<uint8_t, kCardIndexLimit> pos;      // position of each card index in cards
+            uint8_t dealt = 0;
+            uint8_t live = 52;
+
+            void swapPositions(const int a, const int b) {
+                std::swap(cards[a], cards[b]);
+                pos[cards[a]] = a;
+                pos[cards[b]] = b;
             }
-            Deck(std::vector<Card> cardComplement) {
-            // Deck constructor for all cards EXCEPT the argument
-            // TODO: make this fast
-            std::random_device rd;
-            rng.seed(rd());
-            constexpr int nRanks = 13;
-            cards = std::vector<Card>(52);
-            for(int i=0; i<nRanks; i++) {
-                cards[4*i]  =Card(static_cast<Rank>(i), Suit::CLUB);
-                cards[4*i+1]=Card(static_cast<Rank>(i), Suit::DIAMOND);
-                cards[4*i+2]=Card(static_cast<Rank>(i), Suit::HEART);
-                cards[4*i+3]=Card(static_cast<Rank>(i), Suit::SPADE);
+        public:
+            Deck() {
+                int n = 0;
+                CardSet::fullDeck().forEachIndex([this, &n](int i) { cards[n] = i; pos[i] = n++; });
             }
-            for(Card c : cardComplement) {
-            auto it = std::find(cards.begin(), cards.end(), c);
-            if( *it == c)
-                cards.erase(it);
+            Deck(const CardSet& dead) : Deck() { reset(dead); }
+
+            void reset(const CardSet& dead = CardSet()) {
+                // Puts every card back except the dead ones. Costs one swap per dead card
+                dealt = 0;
+                live = 52;
+                (dead & CardSet::fullDeck()).forEachIndex([this](int i) { swapPositions(pos[i], --live); });
             }
+            size_t size() const { return live - dealt; }
+            CardSet remaining() const {
+                CardSet out;
+                for(int i = dealt; i < live; i++) out.insertIndex(cards[i]);
+                return out;
             }
+
+            template<typename URBG>
+                int pop_index(URBG& rng) {
+                    // -1 if the deck is empty
+                    if( dealt == live ) return -1;
+                    swapPositions(dealt, dealt + boundedRandom(rng, live - dealt));
+                    return cards[dealt++];
+                }
+            template<typename URBG>
+                Card pop_card(URBG& rng) {
+                    const int i = pop_index(rng);
+                    return i < 0 ? Card() : indexToCard(i);
+                }
+            template<typename URBG>
+                CardSet pop_cards(URBG& rng, const int n) {
+                    CardSet out;
+                    for(int k = 0; k < n; k++) {
+                        const int i = pop_index(rng);
+                        if( i >= 0 ) out.insertIndex(i);
+                    }
+                    return out;
+                }
     };
 
 
 
 
-    inline std::ostream& operator<<(std::ostream& stream, Deck &a) { 
-        for(int i=0; i<a.size(); i++ )
-            stream << a.cards[i] << " ";
+    inline std::ostream& operator<<(std::ostream& stream, const Deck &a) { 
+        stream << a.remaining();
         return stream;
     }
     inline std::ostream& operator<<(std::ostream& stream, std::vector<Card>& a) { 
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "card.h"
+#include "rng.h"
+
+namespace Poker {
+    // Showdown equity with the board run out to five cards
+    // Every possible deal is enumerated whenever there are no more of them than the requested sample count,
+    // which on the turn and river (and heads-up against known hands from the flop) gives exact answers.
+    // Otherwise deals are sampled on the shared thread pool.
+    struct EquityResult {
+        double win = 0.0;           // fraction of deals won outright
+        double tie = 0.0;           // fraction of deals split with at least one other hand
+        double loss = 0.0;
+        double share = 0.0;         // expected fraction of the pot, counting a k-way split as 1/k
+        double standardError = 0.0; // of share; zero when exact
+        uint64_t samples = 0;       // deals looked at; every possible deal when exact
+        bool exact = false;
+    };
+
+    struct PrecisionTarget {
+        // When adaptive sampling may stop
+        double tolerance = 0.01;            // half-width of the 95% confidence interval on the pot share
+        std::vector<double> thresholds;     // also stop once the interval contains none of these
+        double maxSeconds = 0.0;            // time budget, 0 for none
+        uint64_t maxSamples = 1 << 22;
+    };
+    std::ostream& operator<<(std::ostream& os, const EquityResult& r);
+
+    // Number of distinct ways to finish the board and give numOpponents players two cards each
+    // when numKnown cards are already out of the deck
+    double numPossibleDeals(const int numKnown, const int boardCardsLeft, const int numOpponents);
+
+    // One hand against numOpponents unknown hands
+    EquityResult equityVsRandom(const CardSet& hole, const CardSet& board, const int numOpponents, const uint64_t N, Rng& rng = threadRng());
+
+    // Known hands against each other; the result for hands[i] is at index i
+    std::vector<EquityResult> equityVsHands(const std::vector<CardSet>& hands, const CardSet& board, const uint64_t N, Rng& rng = threadRng());
+
+    // Sample in growing batches until the target is met, instead of a fixed N.
+    // Spots with no more deals than the worst case would need are enumerated exactly
+    EquityResult equityToPrecision(const CardSet& hole, const CardSet& board, const int numOpponents, const PrecisionTarget& target, Rng& rng = threadRng());
+    std::vector<EquityResult> equityVsHandsToPrecision(const std::vector<CardSet>& hands, const CardSet& board, const PrecisionTarget& target, Rng& rng = threadRng());
+}
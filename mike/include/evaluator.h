@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "card.h"
+#include "showdown.h"
+
+namespace Poker {
+    // Lookup-table hand evaluator
+    // Maps 0 to 7 cards to a single HandStrength. A larger HandStrength is a better hand and equal strengths draw.
+    // Flushes are looked up by the 13-bit rank mask of the flush suit, everything else by a hash of the rank counts.
+    // Nothing is allocated per call; the tables are built once on first use.
+    typedef uint16_t HandStrength;
+
+    HandStrength evaluateHand(const CardSet& cards);
+    inline HandStrength evaluateHand(const Card* cards, const size_t n) { return evaluateHand(CardSet(cards, n)); }
+    inline HandStrength evaluateHand(const std::vector<Card>& cards) { return evaluateHand(cards.data(), cards.size()); }
+
+    // HandStrength and FullHandRank order hands identically; decoding is a single table lookup
+    FullHandRank decodeHandStrength(const HandStrength s);
+};
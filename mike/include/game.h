@@ -1,51 +1,77 @@
 #pragma once
 #include<memory>
+#include <algorithm>
+#include <stdexcept>
 #include <list>
 #include <iostream>
 #include <fstream>
 #include "table.h"
 #include "player.h"
+#include "evaluator.h"
+#include "gamestate.h"
 #define PRINT false
 using namespace std;
 
 namespace Poker {
+    struct GameSnapshot {
+        // What playing a hand changes, so Game::restore can put a game back where it was: the engine state, each
+        // seat's bankroll, last move and hand rank and its strategy's rng, and the deck and rng the table deals from.
+        // Other strategy state, like MoveAwareAI's move history or SequenceMoveAI's place in its list, isn't kept, so
+        // a branch is only fully reversible if its moves came from applyMove rather than from strategies.
+        // Seat i is bettingPlayers[i], so a snapshot only makes sense in the hand it was taken in
+        GameState state;
+        int bankroll[GameState::kMaxSeats];
+        PlayerMove move[GameState::kMaxSeats];
+        FullHandRank FHR[GameState::kMaxSeats];
+        Rng strategyRng[GameState::kMaxSeats];  // left alone for seats without a strategy
+        int winnerID = -1;                      // lastRoundWinner's playerID, -1 for none
+        Deck deck;
+        Rng rng;
+    };
+    static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot is copied with memcpy");
+
     class Game {
         public:
-            random_device gameRD = random_device();   // consider removal... this is only used in passing to the Deck
-            // The problem with the above is that when Game is copied, a new random_device is created. Maybe not desirable.
             Table      table;                              // The public members of Table are what are visible to all and will serve as input to the AI
             vector<shared_ptr<Player>> activePlayers;                   // The ones playing the game. This is so you can deactivate players if you wanted to. It should not change during a round
-            vector<shared_ptr<Player>> foldedPlayers;
-            vector<shared_ptr<Player>> allInPlayers;
-            vector<shared_ptr<Player>> bettingPlayers;
+            vector<shared_ptr<Player>> bettingPlayers;                  // The non-bankrupt players in betting order; seat i of state during a round
+            GameState state;                                            // The hand being played
             shared_ptr<Player> lastRoundWinner;
             int nRounds;
 
             bool printMovesToRecord = false;
             map<shared_ptr<Player>, vector<PlayerMove>> moveRecord;
-            vector<Table> tableRecord;  // unintended but maybe doesnt matter: copies of Tables copy a ptr to its players, so no historical Player information can be gleaned from this object
-            // It would be cleaner to only store the information that we want, such as player bankrolls and pot sizes
+            vector<GameSnapshot> record;        // the game as each move found it, when printMovesToRecord is set
 
             Game() { }
             Game(const Table& t) { table = t; }
+            void seed(uint64_t s) {
+                // Makes the deals and every strategy's random choices reproducible
+                // Each gets its own stream split off one generator, so the order players act in doesn't matter
+                Rng source(s);
+                table.rng = source.split();
+                // A seat without a strategy still takes its stream, so making a seat external doesn't reseed the others
+                for(const shared_ptr<Player>& P : table.playerList) {
+                    const Rng stream = source.split();
+                    if( P->strategy ) P->strategy->rng = stream;
+                }
+            }
             void setup() {
                 // The table must have its blinds and bankrolls set up before calling setup
-                table.resetCards(gameRD);
-                activePlayers = table.getPlayersInBettingOrder();
-                allInPlayers.clear();
-                foldedPlayers.clear();
+                // Reuses the vectors' storage, so calling it every round doesn't allocate
+                table.resetCards();
+                activePlayers.assign(table.playerList.begin(), table.playerList.end());
+                table.sortInBettingOrder(activePlayers);
                 lastRoundWinner = nullptr;
                 bettingPlayers.clear();
-                copy_if(activePlayers.begin(), activePlayers.end(), back_inserter(bettingPlayers), [] (shared_ptr<Player> P) { return P->bankroll > 0; });
+                copy_if(activePlayers.begin(), activePlayers.end(), back_inserter(bettingPlayers), [] (const shared_ptr<Player>& P) { return P->bankroll > 0; });
             }
             void resetToDefaults(int n = 6) {
                 // creates a fresh game of standard n player poker
                 const vector<string> aiList (n, "random");
                 table.setPlayerList(aiList);
-                table.resetCards(gameRD);
+                table.resetCards();
                 activePlayers = table.getPlayersInBettingOrder();
-                allInPlayers.clear();
-                foldedPlayers.clear();
                 lastRoundWinner = nullptr;
                 table.setPlayerBankrolls(100);
                 bettingPlayers = activePlayers;
@@ -58,16 +84,16 @@ namespace Poker {
                 // Also rotates seats if desired by shift
                 // Shift = +1 is typical for rotating seats for hold 'em
                 bettingPlayers.clear();
-                copy_if(activePlayers.begin(), activePlayers.end(), back_inserter(bettingPlayers), [] (shared_ptr<Player> P) { return P->bankroll > 0; });
+                copy_if(activePlayers.begin(), activePlayers.end(), back_inserter(bettingPlayers), [] (const shared_ptr<Player>& P) { return P->bankroll > 0; });
                 auto nPlayers = bettingPlayers.size();
                 if( nPlayers > 1 ) {
-                    std::vector<PlayerPosition> playerPositionList = numPlayersToPositionList(nPlayers);
-                    // If players have ill-formed positions, aka repeats, getPlayersInBettingOrder 
+                    const std::vector<PlayerPosition>& playerPositionList = positionsInBettingOrder(nPlayers);
+                    // If players have ill-formed positions, aka repeats, sortInBettingOrder
                     // MAY return equivalent players in arbitrary order (this is behavior from std::sort)
                     // After calling this function, they will have valid positions, however
-                    bettingPlayers = table.getPlayersInBettingOrder(bettingPlayers);
+                    table.sortInBettingOrder(bettingPlayers);
                     for(int i = 0; i < nPlayers; i++ ) {
-                        shared_ptr<Player> P = bettingPlayers[i];
+                        const shared_ptr<Player>& P = bettingPlayers[i];
                         P->setPosition(playerPositionList[i]);
                         if( shift != 0 ) {
                             int newPos = static_cast<int>(P->getPosition());
@@ -82,7 +108,7 @@ namespace Poker {
                 nRounds = 0;
                 auto nPlayers = bettingPlayers.size();
                 while( nPlayers > 1) {
-                    table.resetCards(gameRD);
+                    table.resetCards();
                     doRound();  
                     // rotate player positions
                     setNonBRPlayersPositions(1);
@@ -106,25 +132,28 @@ namespace Poker {
             void doRound() {
                 // Goes around the table taking bets until every player is all-in, folded, or called, then does a showdown
                 // sets lastRoundWinner to a shared_ptr to the winning player
-                // Modifies bettingPlayers and lastRoundWinner
+                // The hand is played on state, seat i being bettingPlayers[i]; table mirrors it for the strategies.
+                // Nothing here allocates unless printMovesToRecord is set
+                startRound();
+                while( !state.over )
+                    applyMove(bettingPlayers[seatToAct()]->makeMove(table, &state));
+            }
 
+            // doRound one decision at a time: startRound deals and posts blinds, then until state.over the seat
+            // seatToAct() owes a move, which applyMove plays. Streets and the showdown happen as the moves complete them
+            void startRound() {
                 // Set everybodies positions and
                 // Fills bettingPlayers with non-bankrupt activePlayers
                 setNonBRPlayersPositions();
+                if( bettingPlayers.size() > GameState::kMaxSeats ) throw std::length_error("Game: too many players for one table");
+                state.reset(bettingPlayers.size());
                 // If only one player, that's the winner!
-                if( bettingPlayers.size() == 1 ) {
-                    lastRoundWinner = bettingPlayers[0];
+                if( bettingPlayers.size() <= 1 ) {
+                    lastRoundWinner = bettingPlayers.empty() ? nullptr : bettingPlayers[0];
+                    state.over = true;
                     return;
                 };
 
-                bettingPlayers = table.getPlayersInBettingOrder(bettingPlayers);
-                const auto bPlayersBackup = bettingPlayers;
-
-                std::shared_ptr<Player> winningPlayer;
-                // bankrolls are updated after the round, transferAmount is used to keep track of what people owe
-                unordered_map<shared_ptr<Player>, int> transferAmount;
-                for_each(bettingPlayers.begin(), bettingPlayers.end(), [&transferAmount] (const shared_ptr<Player>& p) { transferAmount[p]=0;});
-
                 table.clearPlayerHands();
 
                 // clear community cards
@@ -132,202 +161,162 @@ namespace Poker {
 
                 // deal two cards to all active players
                 table.dealPlayersCards(bettingPlayers);
+                for(int seat = 0; seat < state.numSeats; seat++) {
+                    state.stack[seat] = bettingPlayers[seat]->bankroll;
+                    state.hole[seat] = bettingPlayers[seat]->hand;
+                }
 
-                table.street = 0;                      // set to preflop
-                table.pot = 0;
-                table.minimumBet   = table.bigBlind; 
+                state.minimumBet = table.bigBlind;
+                postBlind(PlayerPosition::POS_SB, table.smallBlind);
+                postBlind(PlayerPosition::POS_BB, table.bigBlind);
+                startStreet();
+                advance();
+            }
 
-                // process blind bets
-                auto SB = *find_if(bettingPlayers.begin(), bettingPlayers.end(), [](const shared_ptr<Player>& a) { return a->getPosition() == PlayerPosition::POS_SB;});
-                auto BB = *find_if(bettingPlayers.begin(), bettingPlayers.end(), [](const shared_ptr<Player>& a) { return a->getPosition() == PlayerPosition::POS_BB;});
+            int seatToAct() const { return state.ring[state.toAct]; }          // only while !state.over
+
+            struct Decision {
+                // What the seat to act may do. A move is a total bet for the hand: calling bets minimumBet,
+                // raising any amount between that and bankroll, going all-in bets bankroll, and folding is always allowed
+                int seat;                       // in bettingPlayers
+                int playerID;
+                int minimumBet;
+                int committed;                  // already bet this hand
+                int bankroll;                   // at the start of the hand
+                bool canCall() const { return minimumBet < bankroll; }
+                bool canRaise() const { return minimumBet + 1 < bankroll; }
+                bool legal(const PlayerMove& m) const {
+                    switch( m.move ) {
+                        case Move::MOVE_FOLD: return true;
+                        case Move::MOVE_CALL: return canCall() and m.bet_amount == minimumBet;
+                        case Move::MOVE_RAISE: return m.bet_amount > minimumBet and m.bet_amount < bankroll;
+                        case Move::MOVE_ALLIN: return m.bet_amount == bankroll;
+                        default: return false;
+                    }
+                }
+            };
+            Decision pendingDecision() const {                                  // only while !state.over
+                const int seat = seatToAct();
+                const Player& P = *bettingPlayers[seat];
+                return Decision { seat, P.playerID, state.minimumBet, state.contribution[seat], P.bankroll };
+            }
 
-                if( SB->bankroll > table.smallBlind ) {
-                    table.pot += table.smallBlind;
-                    SB->move.bet_amount = table.smallBlind;
-                    SB->move.move = Move::MOVE_CALL;
-                    transferAmount[SB] = table.smallBlind;
-                } else {
-                    // if paying blind bet bankrupts players, force their move
-                    bettingPlayers.erase(find(bettingPlayers.begin(), bettingPlayers.end(), SB));
-                    allInPlayers.emplace_back(SB);
-                    SB->move.bet_amount = SB->bankroll;
-                    SB->move.move = Move::MOVE_ALLIN;
-                    table.pot += SB->move.bet_amount;
-                    transferAmount[SB] = SB->bankroll;
+            GameSnapshot snapshot() const {
+                GameSnapshot snap;
+                snap.state = state;
+                for(int seat = 0; seat < state.numSeats; seat++) {
+                    const Player& P = *bettingPlayers[seat];
+                    snap.bankroll[seat] = P.bankroll;
+                    snap.move[seat] = P.move;
+                    snap.FHR[seat] = P.FHR;
+                    if( P.strategy ) snap.strategyRng[seat] = P.strategy->rng;
                 }
-                if( BB->bankroll > table.bigBlind ) {
-                    table.pot += table.bigBlind;
-                    BB->move.bet_amount = table.bigBlind;
-                    BB->move.move = Move::MOVE_CALL;
-                    transferAmount[BB] = table.bigBlind;
-                } else {
-                    // if paying blind bet bankrupts players, force their move
-                    bettingPlayers.erase(find(bettingPlayers.begin(), bettingPlayers.end(), BB));
-                    allInPlayers.emplace_back(BB);
-                    BB->move.bet_amount = BB->bankroll;
-                    BB->move.move = Move::MOVE_ALLIN;
-                    table.pot += BB->move.bet_amount;
-                    transferAmount[BB] = BB->bankroll;
+                snap.winnerID = lastRoundWinner ? lastRoundWinner->playerID : -1;
+                snap.deck = table.deck;
+                snap.rng = table.rng;
+                return snap;
+            }
+            void restore(const GameSnapshot& snap) {
+                // Back to the snapshot, which must come from the hand being played
+                state = snap.state;
+                for(int seat = 0; seat < state.numSeats; seat++) {
+                    Player& P = *bettingPlayers[seat];
+                    P.bankroll = snap.bankroll[seat];
+                    P.move = snap.move[seat];
+                    P.FHR = snap.FHR[seat];
+                    if( P.strategy ) P.strategy->rng = snap.strategyRng[seat];
                 }
-                // TODO: clean this shit up!!! ^^^^^^
-                while( table.street < 4) {
-                     
-                    table.dealCommunityCards( table.street );
-                    
-                    bool keepgoing = true;                                                            // indicates that we need another round of betting
-                    #if PRINT
-                    std::cout << "================================================" << std::endl;
-                    std::cout << "Phase " << table.street << " " << table.communityCards <<  std::endl;
-                    #endif
-
+                lastRoundWinner = snap.winnerID < 0 ? nullptr : table.getPlayerByID(snap.winnerID);
+                table.deck = snap.deck;
+                table.rng = snap.rng;
+                table.communityCards = state.board;
+                publish();
+            }
 
-                    while(keepgoing) {
-                        #if PRINT
-                        std::cout << "---------------------------------------" << std::endl;
-                        #endif
+            // applyMove that can be taken back: popMove undoes the most recent pushMove, so a depth-first
+            // search walks the tree with one snapshot per level
+            void pushMove(const PlayerMove& m) {
+                undoStack.push_back(snapshot());
+                applyMove(m);
+            }
+            void popMove() {
+                restore(undoStack.back());
+                undoStack.pop_back();
+            }
 
-                        keepgoing = false;
-                        const int minimumBetBeforeRound = table.minimumBet;
-                        
-                        auto i = bettingPlayers.begin();
-
-                        while (i != bettingPlayers.end()) {
-                            shared_ptr<Player> P = *i;
-                            PlayerMove Pmove =  P->makeMove(make_shared<Table>(table));
-                            const bool allIn = Pmove.move == Move::MOVE_ALLIN;
-                            const bool folded = Pmove.move == Move::MOVE_FOLD;
-                            
-                            // Set the new minimum bet if player raised
-                            table.minimumBet = max(Pmove.bet_amount, table.minimumBet);
-
-                            if( printMovesToRecord ) moveRecord[P].emplace_back(Pmove);
-                            if( printMovesToRecord ) tableRecord.emplace_back(table);
-                            
-                            if( folded ) {
-                                //take their money now
-                                P->bankroll -= transferAmount[P];
-                                transferAmount[P] = 0;
-                                foldedPlayers.emplace_back(P);
-                                i = bettingPlayers.erase(i);
-                            }
-                            else {
-                                // bet_amount should be equal or greater than transferAmount[P]
-                                table.pot += Pmove.bet_amount - transferAmount[P];
-                                transferAmount[P] = Pmove.bet_amount;
-                                if( allIn ) {
-                                    allInPlayers.emplace_back(P);
-                                    i = bettingPlayers.erase(i);
-                                }
-                                else {
-                                    i++;
-                                }
-                            }
-                            // Do another round the table only if somebody raised
-                            if( minimumBetBeforeRound != table.minimumBet ) { keepgoing = true; }
-                            #if PRINT
-                            printPlayerMove(*P, Pmove);
-                            std::cout << "Minimum bet: " << table.minimumBet << std::endl;
-                            std::cout << "Current pot: " << table.pot << std::endl;
-                            #endif
-                        }
-                    }
-                    // advance game
-                    table.street++;
+            bool advanceToDecision() {
+                // Plays the seats whose players have a strategy and stops at one without ("external" in setPlayerList),
+                // which the caller answers with applyDecision. Returns false once the hand is over instead.
+                // Unlike doRound, which gives such a player the default strategy, this lets the decision be made elsewhere
+                while( !state.over ) {
+                    Player& P = *bettingPlayers[seatToAct()];
+                    if( !P.strategy ) return true;
+                    applyMove(P.makeMove(table, &state));
                 }
+                return false;
+            }
 
-                std::vector<shared_ptr<Player>> showdownPlayers;
-                showdownPlayers.insert(showdownPlayers.end(), bettingPlayers.cbegin(), bettingPlayers.cend());
-                showdownPlayers.insert(showdownPlayers.end(), allInPlayers.cbegin(), allInPlayers.cend());
+            void applyDecision(const PlayerMove& Pmove) {
+                // applyMove for a move made outside the engine: throws std::invalid_argument, changing nothing,
+                // unless pendingDecision() allows it
+                if( !pendingDecision().legal(Pmove) )
+                    throw std::invalid_argument("Game: illegal move " + std::to_string(static_cast<int>(Pmove.move)) + " for " + std::to_string(Pmove.bet_amount) + " by seat " + std::to_string(seatToAct()));
+                applyMove(Pmove);
+            }
 
-                winningPlayer = determineWinner(showdownPlayers);
-                // process bankrolls
-                for_each(showdownPlayers.begin(), showdownPlayers.end(), [&transferAmount] (const shared_ptr<Player>& p) {
-                    p->bankroll -= transferAmount[p];
-                    transferAmount[p]=0;
-                });
+            void applyMove(const PlayerMove& Pmove) {
+                const int seat = seatToAct();
+                Player& P = *bettingPlayers[seat];
+                const bool allIn = Pmove.move == Move::MOVE_ALLIN;
+                const bool folded = Pmove.move == Move::MOVE_FOLD;
+                if( printMovesToRecord ) {
+                    moveRecord[bettingPlayers[seat]].emplace_back(Pmove);
+                    record.emplace_back(snapshot());
+                }
+                P.move = Pmove;                 // as Player::makeMove records it, for moves that come from elsewhere
 
-                if( winningPlayer ) {
-                    // finally, reward player
-                    winningPlayer->bankroll += table.pot;
-                    lastRoundWinner = winningPlayer;
-                    #if PRINT
-                    // TODO: fix UNDEF_HAND bug
-                    std::cout << *lastRoundWinner << " won with a " << lastRoundWinner->FHR << std::endl;
-                    #endif
+                // Set the new minimum bet if player raised
+                state.minimumBet = max(Pmove.bet_amount, state.minimumBet);
 
+                if( folded ) {
+                    //take their money now
+                    P.bankroll -= state.contribution[seat];
+                    state.contribution[seat] = 0;
+                    state.fold(state.toAct);
                 }
                 else {
-                    #if PRINT
-                    std::cout << "Draw, returning bets!" << std::endl;
-                    #endif
-                    // else, draw
-                    lastRoundWinner = nullptr;
-                    for( shared_ptr<Player> P : showdownPlayers ) {
-                        P->bankroll += P->move.bet_amount;
-                    }
+                    // bet_amount should be equal or greater than what the player has committed
+                    state.pot += Pmove.bet_amount - state.contribution[seat];
+                    state.contribution[seat] = Pmove.bet_amount;
+                    if( allIn ) state.goAllIn(state.toAct);
+                    else state.toAct++;
                 }
-
-                allInPlayers.clear();
-                foldedPlayers.clear();
-
+                #if PRINT
+                printPlayerMove(P, Pmove);
+                std::cout << "Minimum bet: " << state.minimumBet << std::endl;
+                std::cout << "Current pot: " << state.pot << std::endl;
+                #endif
+                advance();
             }
 
             
             shared_ptr<Player> determineWinner(vector<shared_ptr<Player>>& playersIn ) {
                 // From a vector of pointers to player, returns a pointer to the winner
                 // Modifies the player by populating their FullHandRank
-                auto playersInBegin = playersIn.begin();
-                auto playersInEnd   = playersIn.end();
-                size_t numPlayers = std::distance(playersInBegin, playersInEnd);
-
-                if ( numPlayers == 0) { return nullptr; }   // error
-
-                else if ( numPlayers == 1) {
-                    // just compute the guy's FHR and return him
-                    auto cards = table.communityCards;
-                    cards.insert(cards.end(), playersIn[0]->hand.begin(), playersIn[0]->hand.end());
-                    playersIn[0]->FHR = calcFullHandRank(cards);
-                    return playersIn[0];
-                }
-                else if ( numPlayers >= 2) {
-                    // showdown
-                    // Form hands from community cards and player cards
-                    auto it = playersInBegin;
-                    std::vector<std::vector<Card>> handList;
-                    std::for_each(playersInBegin, playersInEnd, [&](shared_ptr<Player> p) {
-                        std::vector<Card> h (p->hand);  // make a copy of the players hand
-                        handList.emplace_back(h);
-                    });
-
-                    std::for_each(handList.begin(), handList.end(), [&](std::vector<Card>& h) {
-                        auto commCards = table.communityCards;
-                        h.insert(h.end(), commCards.begin(), commCards.end() );       // append community cards to the end of the (copied) players hand
-                    });
-                    
-
-                    
-                    // calculate full hand rank for each hand
-                    std::vector<FullHandRank> FHRs;
-                    std::transform(handList.cbegin(), handList.cend(), std::back_inserter(FHRs), [](std::vector<Card> h) {  return calcFullHandRank(h); });
-                    
-                    auto FHRComparator = [](const FullHandRank& a, const FullHandRank& b) -> bool {
-                        return showdownFHR(a, b) == b;
-                    };
-                    auto winningHandIterator = handList.begin();
-                    // caution... max_element returns only the first max value
-                    std::vector<FullHandRank>::iterator handWinnerFHR = std::max_element(FHRs.begin(), FHRs.end(), FHRComparator);        
-                    advance(winningHandIterator, std::distance(FHRs.begin(), handWinnerFHR));
-                    
-                    
-                    for(size_t i = 0; i < FHRs.size(); i++ )
-                        (playersInBegin + i)->get()->FHR = FHRs[i];
-
-                    shared_ptr<Player> winningPlayer = playersIn[std::distance(handList.begin(), winningHandIterator)];
-                    return winningPlayer;
-                }
-                else {
-                    return nullptr;
+                // On a tie the first of the tied players in playersIn wins
+                if ( playersIn.empty() ) { return nullptr; }   // error
+
+                shared_ptr<Player> winningPlayer;
+                HandStrength bestStrength = 0;
+                for(const shared_ptr<Player>& P : playersIn) {
+                    const HandStrength strength = evaluateHand(P->hand | table.communityCards);
+                    P->FHR = decodeHandStrength(strength);
+                    if( strength > bestStrength ) {
+                        bestStrength = strength;
+                        winningPlayer = P;
+                    }
                 }
+                return winningPlayer;
             }
             
             void print() {
@@ -365,6 +354,141 @@ namespace Poker {
                 myFile.close();
             }
 
+
+        private:
+            vector<GameSnapshot> undoStack;
+
+            void startStreet() {
+                table.dealCommunityCards( state.street );
+                state.board = table.communityCards;
+                state.minimumBetBeforePass = state.minimumBet;
+                state.toAct = 0;
+                #if PRINT
+                std::cout << "================================================" << std::endl;
+                std::cout << "Phase " << state.street << " " << table.communityCards <<  std::endl;
+                #endif
+            }
+
+            void advance() {
+                // Past the end of the ring the pass is over: go round again only if somebody raised,
+                // otherwise deal the next street, or after the river do the showdown
+                while( state.toAct >= state.ringSize ) {
+                    if( state.minimumBet != state.minimumBetBeforePass ) {
+                        state.minimumBetBeforePass = state.minimumBet;
+                        state.toAct = 0;
+                        #if PRINT
+                        std::cout << "---------------------------------------" << std::endl;
+                        #endif
+                        continue;
+                    }
+                    // advance game
+                    state.street++;
+                    if( state.street == 4 ) {
+                        publish();
+                        showdown();
+                        state.over = true;
+                        return;
+                    }
+                    startStreet();
+                }
+                publish();
+            }
+
+            void publish() {
+                // Copies what strategies may see from state to table
+                table.street = state.street;
+                table.pot = state.pot;
+                table.minimumBet = state.minimumBet;
+            }
+
+            void postBlind(const PlayerPosition position, const int blind) {
+                // If paying the blind would bankrupt the player, they are all-in for what they have
+                int seat = 0;
+                while( bettingPlayers[seat]->getPosition() != position ) seat++;
+                Player& P = *bettingPlayers[seat];
+                if( P.bankroll > blind ) {
+                    P.move = PlayerMove(Move::MOVE_CALL, blind);
+                } else {
+                    state.goAllIn(state.ringIndex(seat));
+                    P.move = PlayerMove(Move::MOVE_ALLIN, P.bankroll);
+                }
+                state.pot += P.move.bet_amount;
+                state.contribution[seat] = P.move.bet_amount;
+            }
+
+            void showdown() {
+                // The players still betting, in order, then the all-in players in the order they went all-in.
+                // The first of them with the best hand wins the whole pot
+                uint8_t order[GameState::kMaxSeats];
+                const int n = state.ringSize + state.numAllIn;
+                std::copy(state.ring, state.ring + state.ringSize, order);
+                std::copy(state.allInOrder, state.allInOrder + state.numAllIn, order + state.ringSize);
+
+                int winner = -1;
+                HandStrength bestStrength = 0;
+                for(int i = 0; i < n; i++) {
+                    const HandStrength strength = evaluateHand(state.hole[order[i]] | state.board);
+                    bettingPlayers[order[i]]->FHR = decodeHandStrength(strength);
+                    if( strength > bestStrength ) {
+                        bestStrength = strength;
+                        winner = order[i];
+                    }
+                }
+                // process bankrolls
+                for(int i = 0; i < n; i++) {
+                    bettingPlayers[order[i]]->bankroll -= state.contribution[order[i]];
+                    state.contribution[order[i]] = 0;
+                }
+
+                if( winner >= 0 ) {
+                    // finally, reward player
+                    bettingPlayers[winner]->bankroll += state.pot;
+                    lastRoundWinner = bettingPlayers[winner];
+                    #if PRINT
+                    std::cout << *lastRoundWinner << " won with a " << lastRoundWinner->FHR << std::endl;
+                    #endif
+                }
+                else {
+                    #if PRINT
+                    std::cout << "Draw, returning bets!" << std::endl;
+                    #endif
+                    // else, draw
+                    lastRoundWinner = nullptr;
+                    for(int i = 0; i < n; i++) bettingPlayers[order[i]]->bankroll += bettingPlayers[order[i]]->move.bet_amount;
+                }
+            }
+    };
+
+    struct PendingDecision {
+        Game* game;
+        Game::Decision decision;
     };
+
+    template<typename Decide>
+    void playRoundsInterleaved(std::vector<Game>& games, Decide&& decide) {
+        // Plays one round at every game on this thread, as doRound would, with the external seats' decisions
+        // gathered from all the tables and answered together: decide(pending, moves) fills moves[i] for pending[i].
+        // Throws std::invalid_argument, before applying any of the batch, if a move is missing or not legal.
+        // Each game must be set up (bankrolls, setup()) beforehand
+        std::vector<PendingDecision> pending;
+        std::vector<PlayerMove> moves;
+        for(Game& game : games) {
+            game.startRound();
+            if( game.advanceToDecision() ) pending.push_back(PendingDecision { &game, game.pendingDecision() });
+        }
+        while( !pending.empty() ) {
+            moves.assign(pending.size(), PlayerMove());
+            decide(static_cast<const std::vector<PendingDecision>&>(pending), moves);
+            for(size_t i = 0; i < pending.size(); i++)
+                if( !pending[i].decision.legal(moves[i]) )
+                    throw std::invalid_argument("playRoundsInterleaved: move " + std::to_string(i) + " of the batch is missing or not legal");
+            size_t kept = 0;
+            for(size_t i = 0; i < pending.size(); i++) {
+                Game& game = *pending[i].game;
+                game.applyMove(moves[i]);
+                if( game.advanceToDecision() ) pending[kept++] = PendingDecision { &game, game.pendingDecision() };
+            }
+            pending.resize(kept);
+        }
+    }
 }
-    
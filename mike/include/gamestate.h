@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "card.h"
+
+namespace Poker {
+    struct GameState {
+        // The engine's state for one hand, in fixed arrays for up to kMaxSeats players, so playing a hand allocates
+        // nothing and the whole state is a few cache lines. Seats are numbered in betting order (seat i is
+        // Game::bettingPlayers[i]). ring holds the seats still betting, in order, and shrinks as they fold or go
+        // all-in; allInOrder remembers the order players went all-in, which is the order they show down in after
+        // the seats still in the ring
+        static constexpr int kMaxSeats = 9;
+        enum Status : uint8_t {
+            kFolded = 1,
+            kAllIn = 2
+        };
+
+        int numSeats = 0;
+        int street = 0;
+        int pot = 0;
+        int minimumBet = 0;
+        CardSet board;
+        int stack[kMaxSeats];               // bankroll when the hand started
+        int contribution[kMaxSeats];        // chips committed this hand, paid when the hand ends or on folding
+        uint8_t status[kMaxSeats];
+        CardSet hole[kMaxSeats];
+        uint8_t ring[kMaxSeats];
+        uint8_t ringSize = 0;
+        uint8_t allInOrder[kMaxSeats];
+        uint8_t numAllIn = 0;
+        uint8_t toAct = 0;                  // ring position of the seat to act; the pass ends when it reaches ringSize
+        int minimumBetBeforePass = 0;       // another pass follows if the minimum bet has changed since
+        bool over = false;                  // the hand is finished and paid out
+
+        void reset(const int n) {
+            // n seats, nothing committed, everyone betting
+            numSeats = n;
+            street = pot = minimumBet = minimumBetBeforePass = 0;
+            board.clear();
+            ringSize = numAllIn = toAct = 0;
+            over = false;
+            for(int i = 0; i < n; i++) {
+                contribution[i] = 0;
+                status[i] = 0;
+                hole[i].clear();
+                ring[ringSize++] = i;
+            }
+        }
+
+        bool betting(const int seat) const { return !(status[seat] & (kFolded | kAllIn)); }
+
+        // Takes the seat at ring position k out of the ring, keeping the others in order
+        void leaveRing(const int k) {
+            std::memmove(ring + k, ring + k + 1, ringSize - k - 1);
+            ringSize--;
+        }
+        void fold(const int k) {
+            status[ring[k]] |= kFolded;
+            leaveRing(k);
+        }
+        void goAllIn(const int k) {
+            status[ring[k]] |= kAllIn;
+            allInOrder[numAllIn++] = ring[k];
+            leaveRing(k);
+        }
+        int ringIndex(const int seat) const {
+            for(int k = 0; k < ringSize; k++) if( ring[k] == seat ) return k;
+            return -1;
+        }
+    };
+    static_assert(std::is_trivially_copyable<GameState>::value, "GameState is copied with memcpy");
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "card.h"
+
+namespace Poker {
+    class HandBuckets {
+        // Card abstraction: every hand, up to suit isomorphism (HandIndexer::forStreet), is mapped to one of a few
+        // buckets per street, so looking a hand up at play time is one index computation and one byte.
+        // Hands are clustered with k-means on what their equity against a random hand looks like at the river:
+        // on the flop and turn the whole distribution over runouts (a histogram compared by earth mover's or L2
+        // distance), its mean (EHS) or its mean square (EHS^2); on the river the exact EHS.
+        // Features are computed one canonical board at a time, for every hole-card pair at once: a river board is
+        // evaluated once for all 1081 hands, so the cost is per board rather than per hand. Boards run on the
+        // shared pool, each from its own seeded stream, so a seeded build is the same on any number of threads.
+        // Saved as a small versioned binary file (native byte order) so it is computed once
+        public:
+            static constexpr uint32_t kVersion = 1;
+            static constexpr uint64_t kNoBuckets = 0;       // fingerprint of ReducedFullHandRank classes, i.e. no buckets
+            static constexpr int kMaxBuckets = 256;        // buckets fit the 8-bit hand class of a CFRAI1 infoset key
+            static constexpr int kNumStreets = 4;
+
+            enum class Feature { EHS, EHS2, Histogram };
+            enum class Metric { L2, EMD };
+            static Feature parseFeature(const std::string& name);      // "ehs", "ehs2", "histogram"
+            static Metric parseMetric(const std::string& name);        // "l2", "emd"
+
+            struct Settings {
+                std::array<int, kNumStreets> buckets = {169, 64, 64, 64};  // 0 leaves a street unbucketed; 169 or more preflop is lossless
+                Feature feature = Feature::Histogram;   // flop and turn; the river is always clustered by EHS
+                Metric metric = Metric::EMD;            // for histograms; scalar features use L2
+                int histogramBins = 32;
+                int runouts = 64;                       // board completions per board, all of them when there are no more
+                int trainingBoards = 64;                // random boards whose hands k-means is fitted to, per street
+                int iterations = 25;                    // of Lloyd's algorithm
+                uint64_t seed = 1;
+            };
+
+            static HandBuckets build(const Settings& settings);
+            bool save(const std::string& path) const;
+            bool load(const std::string& path);        // false, leaving the buckets untouched, if the file is missing or stale
+
+            bool covers(const int street) const { return street >= 0 and street < kNumStreets and numBuckets[street] > 0; }
+            int size(const int street) const { return numBuckets[street]; }
+            int bucket(const int street, const uint64_t index) const { return table[street][index]; }
+            int bucket(const CardSet& hole, const CardSet& board) const;       // -1 when the street isn't covered
+
+            // Hash of the bucket counts and tables, which policy files record to be used only with the buckets they
+            // were trained with; kNoBuckets for nullptr
+            static uint64_t fingerprint(const HandBuckets* buckets) { return buckets ? buckets->hash : kNoBuckets; }
+
+        private:
+            std::array<int, kNumStreets> numBuckets {};
+            std::array<std::vector<uint8_t>, kNumStreets> table;                // indexed by HandIndexer::forStreet
+            uint64_t hash = kNoBuckets;
+            void rehash();              // after the tables change
+    };
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Poker {
+    // 64-bit FNV-1a, for the checksums and fingerprints in the binary file headers. Pass the previous hash as h to
+    // hash several buffers as if they were one
+    constexpr uint64_t kFnv1aOffset = 0xcbf29ce484222325ULL;
+
+    inline uint64_t fnv1a(const void* data, const size_t n, uint64_t h = kFnv1aOffset) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < n; i++) {
+            h ^= p[i];
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "strategy.h"
+
+namespace Poker {
+    struct HeadsUpSettings {
+        int stack = 100;                // both players start every hand with this bankroll
+        int smallBlind = 5;
+        int bigBlind = 10;
+    };
+
+    struct HeadsUpState {
+        // Public betting state of one heads-up hand between CFRAI1-style players, as Game::doRound plays it:
+        // the small blind acts first on every street, Call matches the minimum bet, Raise doubles it, AllIn commits
+        // the whole stack, and a street goes round again while somebody raises. Unlike doRound the hand ends as soon
+        // as someone folds. Small enough to copy at every node of a tree walk
+        using BPM = CFRAI1::BinnedPlayerMove;
+        static constexpr int kNumActions = CFRAI1::kNumBinnedMoves;
+        static constexpr int kNumStreets = 4;
+        static constexpr PlayerPosition kSeatPosition[2] = { PlayerPosition::POS_SB, PlayerPosition::POS_BB };
+
+        int street = 0;
+        int toAct = -1;                     // seat 0 is the small blind, seat 1 the big blind
+        int minimumBet = 0;
+        int minimumBetBeforePass = 0;
+        int committed[2] = {};
+        bool folded[2] = {};
+        bool allIn[2] = {};
+        BPM lastMove[2] = { BPM::Undef, BPM::Undef };
+
+        static HeadsUpState start(const HeadsUpSettings& settings);      // blinds posted, small blind to act
+
+        bool betting(const int seat) const { return !folded[seat] and !allIn[seat]; }
+        bool terminal() const { return folded[0] or folded[1] or street == kNumStreets; }
+
+        void legalActions(const HeadsUpSettings& settings, bool legal[]) const;
+        HeadsUpState apply(const HeadsUpSettings& settings, const int a) const;
+
+        // The key CFRAI1 looks up when seat holds a hand of the given class (CFRAI1::handClassOf) in this state
+        CFRAI1::InfosetKey key(const int seat, const int handClass) const;
+
+        // Chips seat wins (or loses) at a terminal state; strength decides a showdown and equal hands split
+        template<typename Strength>
+            double utility(const int seat, const Strength mine, const Strength theirs) const {
+                const int other = 1 - seat;
+                if( folded[seat] ) return -committed[seat];
+                if( folded[other] ) return committed[other];
+                if( mine > theirs ) return committed[other];
+                if( mine < theirs ) return -committed[seat];
+                return 0.0;
+            }
+
+        private:
+            void nextToAct();
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include "card.h"
+#include "evaluator.h"
+
+namespace Poker {
+    struct HoleCards {
+        // Every hole-card pair, numbered in order of their card indices, with its two card indices for card removal
+        static constexpr int kNumHands = 1326;
+        CardSet set[kNumHands];
+        uint8_t card[kNumHands][2];
+
+        static const HoleCards& all();          // built once
+    };
+
+    // The hands that fit a five-card board: strength[h] of each and their numbers in order, weakest first.
+    // Returns how many there are
+    int rankRiverHands(const CardSet& board, HandStrength strength[HoleCards::kNumHands], uint16_t order[HoleCards::kNumHands]);
+
+    template<typename Weight, typename Visit>
+    void sweepByStrength(const uint16_t* order, const int n, const HandStrength* strength, Weight&& weight, Visit&& visit) {
+        // Sweeps the ranked hands once up and once down. visit(pass, h, mass) gets the total weight of the hands
+        // sharing no card with h that are weaker (pass 0) or stronger (pass 1); hands of equal strength count as neither
+        using Mass = decltype(weight(0));
+        const HoleCards& hands = HoleCards::all();
+        for(int pass = 0; pass < 2; pass++) {
+            const auto at = [&](const int k) { return pass == 0 ? order[k] : order[n - 1 - k]; };
+            Mass mass = 0;
+            Mass withCard[kCardIndexLimit] = {};
+            for(int i = 0; i < n; ) {
+                int j = i;
+                while( j < n and strength[at(j)] == strength[at(i)] ) j++;
+                for(int k = i; k < j; k++) {
+                    const int h = at(k);
+                    visit(pass, h, mass - withCard[hands.card[h][0]] - withCard[hands.card[h][1]]);
+                }
+                for(int k = i; k < j; k++) {
+                    const int h = at(k);
+                    const Mass w = weight(h);
+                    mass += w;
+                    withCard[hands.card[h][0]] += w;
+                    withCard[hands.card[h][1]] += w;
+                }
+                i = j;
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Poker {
+    template<int Width>
+    class InfosetTable {
+        // Open-addressing hash table from 64-bit infoset keys to Width floats stored inline in the slot
+        // Lookups and inserts are lock-free: a slot is claimed by a CAS on its key, and every value is its own
+        // atomic, so any number of threads can read and accumulate into the table at once.
+        // New entries start at zero. Growing rehashes every entry and must not run alongside anything else
+        public:
+            static constexpr uint64_t kEmpty = ~0ULL;     // never a valid key
+            struct Slot {
+                std::atomic<uint64_t> key { kEmpty };
+                std::atomic<float> values[Width];
+                Slot() { for(auto& v : values) v.store(0.0f, std::memory_order_relaxed); }
+            };
+
+            explicit InfosetTable(const size_t capacity = 1024) { allocate(capacity); }
+            InfosetTable(const InfosetTable& other) { *this = other; }
+            InfosetTable& operator=(const InfosetTable& other) {
+                if( this == &other ) return *this;
+                allocate(other.capacity());
+                other.forEach([this](const uint64_t key, const std::array<float, Width>& values) { insertValues(key, values); });
+                return *this;
+            }
+
+            size_t size() const { return count.load(std::memory_order_relaxed); }
+            size_t capacity() const { return mask + 1; }
+            bool needsGrowth() const { return size() * 2 > capacity(); }       // keeps probe sequences short
+
+            Slot* find(const uint64_t key) const {
+                for(size_t i = 0, h = hash(key); i <= mask; i++, h++) {
+                    Slot& s = slots[h & mask];
+                    const uint64_t k = s.key.load(std::memory_order_acquire);
+                    if( k == key ) return &s;
+                    if( k == kEmpty ) return nullptr;
+                }
+                return nullptr;
+            }
+
+            // The slot for key and whether this call created it; nullptr only if the table is completely full
+            std::pair<Slot*, bool> findOrInsert(const uint64_t key) {
+                for(size_t i = 0, h = hash(key); i <= mask; i++, h++) {
+                    Slot& s = slots[h & mask];
+                    uint64_t k = s.key.load(std::memory_order_acquire);
+                    if( k == kEmpty ) {
+                        if( s.key.compare_exchange_strong(k, key, std::memory_order_acq_rel) ) {
+                            count.fetch_add(1, std::memory_order_relaxed);
+                            return { &s, true };
+                        }
+                        // somebody else claimed it first; k now holds their key
+                    }
+                    if( k == key ) return { &s, false };
+                }
+                return { nullptr, false };
+            }
+
+            void reserve(const size_t n) {
+                // Not thread-safe
+                if( n <= capacity() ) return;
+                InfosetTable bigger(n);
+                forEach([&bigger](const uint64_t key, const std::array<float, Width>& values) { bigger.insertValues(key, values); });
+                slots = std::move(bigger.slots);
+                mask = bigger.mask;
+            }
+            void grow() { reserve(2 * capacity()); }
+            void clear() { allocate(capacity()); }
+
+            // f(key, values) for every entry, in slot order
+            template<typename F>
+                void forEach(F&& f) const {
+                    for(size_t i = 0; i <= mask; i++) {
+                        const uint64_t k = slots[i].key.load(std::memory_order_acquire);
+                        if( k == kEmpty ) continue;
+                        std::array<float, Width> values;
+                        for(int a = 0; a < Width; a++) values[a] = slots[i].values[a].load(std::memory_order_relaxed);
+                        f(k, values);
+                    }
+                }
+
+            // f(slot) for every entry, allowing changes; not thread-safe
+            template<typename F>
+                void forEachSlot(F&& f) {
+                    for(size_t i = 0; i <= mask; i++)
+                        if( slots[i].key.load(std::memory_order_relaxed) != kEmpty ) f(slots[i]);
+                }
+
+            // Atomically replaces v by f(v)
+            template<typename F>
+                static void update(std::atomic<float>& v, F&& f) {
+                    float old = v.load(std::memory_order_relaxed);
+                    while( !v.compare_exchange_weak(old, f(old), std::memory_order_relaxed) ) {}
+                }
+            static void add(std::atomic<float>& v, const float x) { update(v, [x](const float old) { return old + x; }); }
+
+        private:
+            std::unique_ptr<Slot[]> slots;
+            size_t mask = 0;
+            std::atomic<size_t> count { 0 };
+
+            void allocate(size_t capacity) {
+                size_t n = 16;
+                while( n < capacity ) n <<= 1;
+                slots.reset(new Slot[n]);
+                mask = n - 1;
+                count.store(0, std::memory_order_relaxed);
+            }
+
+            void insertValues(const uint64_t key, const std::array<float, Width>& values) {
+                Slot* s = findOrInsert(key).first;
+                for(int a = 0; a < Width; a++) s->values[a].store(values[a], std::memory_order_relaxed);
+            }
+
+            static size_t hash(uint64_t key) {
+                // splitmix64 finalizer; packed keys put most of their entropy in a few low bits
+                key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+                return static_cast<size_t>(key ^ (key >> 31));
+            }
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "card.h"
+
+namespace Poker {
+    class HandIndexer {
+        // Dense index of hands up to suit isomorphism (after Waugh, "A Fast and Optimal Hand Isomorphism Algorithm")
+        // A hand is dealt in rounds, e.g. {2, 3}: two hole cards then three board cards. Hands that differ only by a
+        // renaming of suits share an index, and the indices of a round cover exactly [0, size()).
+        // Each suit's cards are ranked as a pattern of rank sets per round; suits with the same per-round card
+        // counts are interchangeable, so each such group contributes a multiset of patterns.
+        public:
+            explicit HandIndexer(const std::vector<int>& cardsPerRound);
+
+            // Hole cards plus an unordered board: street 0..3 is {2}, {2,3}, {2,4}, {2,5},
+            // with 169, 1286792, 13960050 and 123156254 classes
+            static const HandIndexer& forStreet(const int street);
+
+            int numRounds() const { return static_cast<int>(cardsPerRound.size()); }
+            uint64_t size() const { return total; }
+
+            uint64_t index(const CardSet* rounds) const;                  // rounds[r] holds the cards dealt in round r
+            uint64_t index(const CardSet& hole, const CardSet& board) const;
+            void unindex(uint64_t idx, CardSet* rounds) const;           // writes one hand of the class
+
+        private:
+            struct Group {
+                uint32_t counts;            // cards per round, a nibble each, first round highest
+                int numSuits;
+                uint64_t numPatterns;       // ways one suit can hold those counts
+                uint64_t size;              // multisets of numSuits patterns
+            };
+            struct Configuration {
+                uint64_t key;               // the four suits' counts, sorted descending, first suit highest
+                uint64_t offset;
+                uint64_t size;
+                std::vector<Group> groups;
+            };
+
+            std::vector<int> cardsPerRound;
+            std::vector<Configuration> configurations;      // ascending key, so offsets ascend too
+            uint64_t total = 0;
+
+            void enumerateConfigurations(const int round, const int suit, const int left, uint32_t counts[], std::vector<uint64_t>& keys) const;
+            uint64_t numPatterns(const uint32_t counts) const;
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include "headsup.h"
+#include "infosettable.h"
+#include "regret.h"
+#include "rng.h"
+#include "strategy.h"
+
+namespace Poker {
+    class MCCFRTrainer {
+        // External-sampling Monte Carlo CFR (Lanctot et al., "Monte Carlo Sampling for Regret Minimization") for the
+        // heads-up hand HeadsUpState models, between two CFRAI1 players.
+        // Infosets are the same ReducedGameState keys CFRAI1 looks up, so the average strategy is a policy it plays directly.
+        // Regrets and strategy sums follow settings.rule (vanilla, CFR+, linear or discounted CFR, optionally pruned),
+        // with each block of iterationsPerDiscount iterations counting as one iteration of the rule's schedule.
+        // Traversals run on the shared thread pool and all update one lock-free table; with more than one worker the
+        // order of the floating point additions varies, so seeded runs are only bit-reproducible on a single thread
+        public:
+            struct Settings : HeadsUpSettings {
+                RegretRule rule;                // CFR variant and pruning
+                uint64_t iterationsPerDiscount = 1 << 14;       // iterations the rule's discounts treat as one
+                std::shared_ptr<const HandBuckets> buckets;     // card abstraction, on the streets it covers
+            };
+            using Key = CFRAI1::InfosetKey;
+            static constexpr int kNumActions = CFRAI1::kNumBinnedMoves;
+
+            MCCFRTrainer() : MCCFRTrainer(Settings()) {}
+            explicit MCCFRTrainer(const Settings& settings);
+
+            // One traversal per player per iteration, each on its own sampled deal.
+            // Returns the sampled value of the game to the small blind, in chips per hand
+            double train(const uint64_t iterations, Rng& rng = threadRng());
+
+            uint64_t iterations() const { return numIterations; }
+            size_t numInfosets() const { return table.size(); }
+
+            // Average strategy in BinnedPlayerMove order; uniform for an infoset that was never reached
+            std::array<float, kNumActions> averageStrategy(const Key key) const;
+            void exportPolicy(CFRAI1& ai) const;        // replaces ai's table with the average strategy and shares the buckets
+
+        private:
+            Settings settings;
+            InfosetTable<2 * kNumActions> table;        // current regrets, then strategy sums
+            uint64_t numIterations = 0;
+            uint64_t numDiscounts = 0;
+
+            void discount();            // applies the rule's discounts for the batch that just finished
+    };
+}
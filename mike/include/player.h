@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <array>
 #include <memory>
 #include <algorithm>
 #include <iterator>
@@ -10,6 +11,7 @@
 namespace Poker{
     struct Strategy;
     class Table;
+    struct GameState;
 
     enum class Move : int {
         MOVE_UNDEF = -1,
@@ -107,10 +109,31 @@ namespace Poker{
                 ret.emplace_back(PP::POS_SB);
                 ret.emplace_back(PP::POS_BB);
                 break;
+            case 9:
+                ret.emplace_back(PP::POS_UTG);
+                ret.emplace_back(PP::POS_UTG1);
+                ret.emplace_back(PP::POS_UTG2);
+                ret.emplace_back(PP::POS_UTG3);
+                ret.emplace_back(PP::POS_HJ);
+                ret.emplace_back(PP::POS_CO);
+                ret.emplace_back(PP::POS_BTN);
+                ret.emplace_back(PP::POS_SB);
+                ret.emplace_back(PP::POS_BB);
+                break;
         }
         return ret;
     };
 
+    inline const std::vector<PlayerPosition>& positionsInBettingOrder (const int n) {
+        // numPlayersToPositionList, built once per table size so the game loop can look it up every round
+        static const std::array<std::vector<PlayerPosition>, 10> lists = [] {
+            std::array<std::vector<PlayerPosition>, 10> l;
+            for(int i = 0; i < 10; i++) l[i] = numPlayersToPositionList(i);
+            return l;
+        }();
+        return lists.at(n);
+    };
+
 
     class Player {
         public:
@@ -119,7 +142,7 @@ namespace Poker{
             PlayerPosition  position;                      // seat the player is on. 0 = UTG, 1 = MP, 2 = CO, 3 = BTN, 4 = SB, 5 = BB 
             PlayerMove  move;
             FullHandRank FHR;
-            std::vector<Card> hand;
+            CardSet hand;
             std::shared_ptr<Strategy> strategy;
             
             Player() = default;
@@ -137,7 +160,8 @@ namespace Poker{
             void setPlayerID(const int& id) { this->playerID = id; }
             void resetHand();
             inline bool isBankrupt();
-            PlayerMove makeMove(std::shared_ptr<Table> tableInfo);
+            // Asks the strategy, through a TableView of table and of hand, the engine state of the Game playing it if any
+            PlayerMove makeMove(const Table& table, const GameState* hand = nullptr);
     };
 
     
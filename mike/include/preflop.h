@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "card.h"
+#include "equity.h"
+#include "rng.h"
+
+namespace Poker {
+    // The 169 starting hands that differ only up to suits, laid out as the usual 13x13 chart:
+    // class = 13*row + column, pairs on the diagonal, suited hands where row > column (row = higher rank)
+    // and offsuit hands where row < column (column = higher rank)
+    constexpr int kNumPreflopClasses = 169;
+    int preflopClass(const CardSet& hole);          // -1 unless hole is exactly two cards
+    CardSet preflopClassHand(const int cls);        // one hand of the class
+    std::string preflopClassName(const int cls);    // "AA", "AKs", "72o"
+
+    class PreflopTable {
+        // Pot share of every starting hand against 1 to kMaxOpponents random hands, board run out
+        // Saved as a small versioned binary file (native little-endian floats) so it is computed once
+        public:
+            static constexpr uint32_t kVersion = 1;
+            static constexpr int kMaxOpponents = 8;
+
+            // Computes every entry on the shared thread pool, each to the given precision
+            static PreflopTable generate(const PrecisionTarget& target, Rng& rng = threadRng());
+            bool save(const std::string& path) const;
+            bool load(const std::string& path);        // false, leaving the table untouched, if the file is missing or stale
+
+            bool covers(const int numOpponents) const { return numOpponents >= 1 and numOpponents <= kMaxOpponents; }
+            double equity(const int cls, const int numOpponents) const { return table[cls][numOpponents - 1]; }
+            double equity(const CardSet& hole, const int numOpponents) const { return equity(preflopClass(hole), numOpponents); }
+
+            void printChart(std::ostream& os, const int numOpponents) const;
+
+        private:
+            std::array<std::array<float, kMaxOpponents>, kNumPreflopClasses> table {};
+    };
+
+    // The table in POKER_PREFLOP_TABLE, or preflop_equity.bin in the working directory, loaded on first use.
+    // nullptr when there is no valid file; callers fall back to computing equity
+    const PreflopTable* preflopTable();
+}
@@ -2,12 +2,30 @@
 
 namespace Poker {
 
+struct RegretRule;
+
 
 void pyMonteCarloGames(const uint64_t& N);
 
 
 double pyMonteCarloRounds(const uint64_t& N, std::vector<int> params);
+std::tuple<std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>>
+pyMonteCarloDuplicateRounds(const uint64_t& N, const std::vector<std::vector<double>>& candidates);
 double pyMCSingleHand(const std::vector<std::tuple<int,int>>& cardsA, const std::vector<std::tuple<int,int>>& commCards, const int numOtherPlayers, const uint64_t N);
+std::tuple<double,double,uint64_t> pyEquityToPrecision(const std::vector<std::tuple<int,int>>& cardsA, const std::vector<std::tuple<int,int>>& commCards, const int numOtherPlayers, const double tolerance, const double maxSeconds);
+std::tuple<double,uint64_t> pyTrainCFR(const uint64_t iterations, const std::string& outfile, const int stack, const int smallBlind, const int bigBlind,
+                                       const RegretRule& rule, const std::string& bucketfile);
+std::tuple<double,double,double> pyExploitability(const std::string& policyfile, const int stack, const int smallBlind, const int bigBlind,
+                                                  const int flops, const int turnsPerFlop, const int riversPerTurn, const uint64_t seed,
+                                                  const std::string& bucketfile);
+std::tuple<double,double,double,bool> pyEquity(const std::vector<std::tuple<int,int>>& cardsA, const std::vector<std::tuple<int,int>>& commCards, const int numOtherPlayers, const uint64_t N);
+
+// Batches of card codes (4 * (rank - 2) + suit - 1 in Charles's convention, negative for an empty slot), row-major
+std::vector<int> pyEncodeCards(const std::vector<std::tuple<int,int>>& cards);
+CardSet codesToCardSet(const int32_t* codes, const size_t k);
+void evaluateHandsBatch(const int32_t* cards, const size_t n, const size_t k, uint16_t* strength);
+void showdownHandsBatch(const int32_t* cardsA, const int32_t* cardsB, const int32_t* board, const size_t n, const size_t kBoard, int8_t* result);
+void equityBatch(const int32_t* cards, const size_t n, const size_t k, const int numOtherPlayers, const uint64_t N, double* wtl);
 
 int pyShowdownHands(std::vector<std::tuple<int,int>> tupleIntsA, std::vector<std::tuple<int,int>> tupleIntsB, 
                     std::vector<std::tuple<int,int>> communityTupleInts);
@@ -16,4 +34,8 @@ std::vector<Card> convertCharlesToMike(std::vector<std::tuple<int,int>> in); //c
 
 std::vector<std::tuple<int, int>> convertMikeToCharles(std::vector<Card> in); //ditto but in the other direction
 
+CardSet convertCharlesToCardSet(const std::vector<std::tuple<int,int>>& in);
+
+std::vector<std::tuple<int, int>> convertCardSetToCharles(const CardSet& in);
+
 }
\ No newline at end of file
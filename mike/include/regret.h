@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace Poker {
+    enum class CFRVariant : int {
+        Vanilla = 0,            // plain regret matching and uniform averaging
+        CFRPlus = 1,            // regrets floored at zero, linearly weighted average (Tammelin 2014)
+        Linear = 2,             // every regret and strategy sum weighted by its iteration (DCFR with 1, 1, 1)
+        Discounted = 3          // DCFR(alpha, beta, gamma) (Brown & Sandholm, "Solving Imperfect-Information Games via Discounted Regret Minimization")
+    };
+    CFRVariant parseCFRVariant(const std::string& name);      // "vanilla", "cfr+", "linear" or "dcfr"; throws std::invalid_argument otherwise
+
+    struct RegretRule {
+        // How accumulated regrets and average-strategy sums change from one iteration to the next.
+        // The discounts are applied to the totals after each iteration, which for DCFR is the same as weighting
+        // iteration t's contributions by the product of every later discount
+        CFRVariant variant = CFRVariant::Discounted;
+        double alpha = 1.5;         // positive regrets are scaled by t^alpha / (t^alpha + 1) after iteration t
+        double beta = 0.0;          // negative regrets by t^beta / (t^beta + 1)
+        double gamma = 2.0;         // strategy sums by (t / (t + 1))^gamma
+
+        // Regret-based pruning: once pruneAfter iterations have run, a fraction pruneProbability of traversals skip
+        // actions whose regret is below pruneThreshold. The default threshold never prunes
+        double pruneThreshold = -std::numeric_limits<double>::infinity();
+        uint64_t pruneAfter = 0;
+        double pruneProbability = 0.95;
+
+        struct Discount {
+            double positive = 1.0;
+            double negative = 1.0;
+            double strategy = 1.0;
+            bool identity() const { return positive == 1.0 and negative == 1.0 and strategy == 1.0; }
+        };
+        Discount discountAfter(const uint64_t t) const;                // t counts from 1
+
+        double accumulate(const double regret, const double delta) const {
+            const double r = regret + delta;
+            return variant == CFRVariant::CFRPlus and r < 0.0 ? 0.0 : r;
+        }
+        bool prunable(const double regret) const { return regret < pruneThreshold; }
+        bool pruningEnabled(const uint64_t iterationsDone) const {
+            return pruneThreshold > -std::numeric_limits<double>::infinity() and iterationsDone >= pruneAfter;
+        }
+
+        // Strategy in proportion to positive regret over the legal actions, uniform when none is positive.
+        // legal may be nullptr when every action is legal
+        static void regretMatching(const float* regrets, const bool* legal, const int n, float* strategy);
+    };
+}
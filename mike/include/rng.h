@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+
+namespace Poker {
+    class Rng {
+        // xoshiro256** (Blackman & Vigna): 256 bits of state, a handful of ALU ops per number,
+        // and jump functions that split one seed into non-overlapping streams.
+        // Satisfies UniformRandomBitGenerator, so it works with Deck and the <random> distributions
+        public:
+            typedef uint64_t result_type;
+            static constexpr result_type min() { return 0; }
+            static constexpr result_type max() { return UINT64_MAX; }
+
+            Rng() : Rng(0) {};
+            explicit Rng(uint64_t seed) { this->seed(seed); }
+            void seed(uint64_t seed) {
+                // splitmix64 spreads the seed over the whole state, so nearby seeds give unrelated streams
+                for(uint64_t& word : s) {
+                    uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+                    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                    word = z ^ (z >> 31);
+                }
+            }
+
+            result_type operator()() {
+                const uint64_t result = rotl(s[1] * 5, 7) * 9;
+                const uint64_t t = s[1] << 17;
+                s[2] ^= s[0];
+                s[3] ^= s[1];
+                s[1] ^= s[2];
+                s[0] ^= s[3];
+                s[2] ^= t;
+                s[3] = rotl(s[3], 45);
+                return result;
+            }
+            double uniform() { return ((*this)() >> 11) * 0x1.0p-53; }     // [0, 1)
+
+            // Advance by 2^128 and 2^192 numbers respectively
+            void jump()     { doJump(kJump); }
+            void longJump() { doJump(kLongJump); }
+
+            Rng split() {
+                // The returned generator continues this stream; this one jumps ahead to a fresh, non-overlapping one
+                Rng child = *this;
+                jump();
+                return child;
+            }
+
+        private:
+            uint64_t s[4];
+
+            static constexpr uint64_t kJump[4]     = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+            static constexpr uint64_t kLongJump[4] = { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+
+            static uint64_t rotl(const uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+            void doJump(const uint64_t (&poly)[4]) {
+                uint64_t t[4] = {0, 0, 0, 0};
+                for(const uint64_t word : poly)
+                    for(int b = 0; b < 64; b++) {
+                        if( word & (1ULL << b) )
+                            for(int i = 0; i < 4; i++) t[i] ^= s[i];
+                        (*this)();
+                    }
+                for(int i = 0; i < 4; i++) s[i] = t[i];
+            }
+    };
+
+    // Process-wide seeding
+    // Every stream comes from one master generator, seeded from POKER_SEED if set or std::random_device otherwise.
+    // Streams are handed out in order, so a run that creates its generators in the same order is reproducible.
+    void setMasterSeed(uint64_t seed);      // reseeds the master and invalidates every threadRng()
+    uint64_t getMasterSeed();
+    Rng newRngStream();                     // thread-safe
+    Rng& threadRng();                       // this thread's own stream, for callers that don't pass one
+}
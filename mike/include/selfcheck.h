@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+
+namespace Poker {
+    // Regression checks of the table-driven code against slow reference versions, run by "poker selfcheck" and ctest.
+    // Each reports what it covered on out and returns false at the first mismatch
+    bool selfCheckEvaluator(std::ostream& out, const uint64_t numSevenCardHands);     // every 5-card hand, then random 7-card hands
+    bool selfCheckHandIndexer(std::ostream& out, const uint64_t numSamples);          // every preflop and flop class, then random turn and river hands
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <unordered_map>
 #include <algorithm>
 #include <list>
@@ -25,14 +26,33 @@ namespace Poker {
     };
     
     struct FullHandRank {
-        // Holds full ranking information about a hand
-        HandRank handrank;                  
-        std::vector<Card> maincards;        
-        std::vector<Card> kickers;          
+        // Holds full ranking information about a hand packed into one integer, so hands compare with plain < and ==
+        // bits 20-23: HandRank
+        // bits  0-19: up to five ranks, main ranks first and then kickers, from the top nibble down
+        //             Each is stored as rank+1 so that a missing kicker sorts below a deuce
+        uint32_t value = 0;
+
+        FullHandRank() = default;
+        explicit FullHandRank(uint32_t v) : value(v) {};
+        HandRank handrank() const { return static_cast<HandRank>(value >> 20); }
+        Rank rankAt(size_t i) const { return static_cast<Rank>(static_cast<int>((value >> (16 - 4*i)) & 0xf) - 1); }
+        size_t numMainRanks() const {
+            switch (handrank()) {
+                case HandRank::UNDEF_HANDRANK:  return 0;
+                case HandRank::TWO_PAIR:        return 2;
+                case HandRank::FULL_HOUSE:      return 2;
+                case HandRank::FLUSH:           return 5;
+                default:                        return 1;
+            }
+        }
+        Rank mainRank(size_t i) const { return rankAt(i); }
+        Rank kicker(size_t i) const { return rankAt(numMainRanks() + i); }
     };
-    static FullHandRank nullFHR;            // for erroneous FHRs
+    inline bool operator==(const FullHandRank& a, const FullHandRank& b) { return a.value == b.value; }
+    inline bool operator!=(const FullHandRank& a, const FullHandRank& b) { return a.value != b.value; }
+    inline bool operator<(const FullHandRank& a, const FullHandRank& b) { return a.value < b.value; }
+    inline bool operator>(const FullHandRank& a, const FullHandRank& b) { return a.value > b.value; }
 
-    bool operator==(const FullHandRank& a, const FullHandRank& b);
     std::ostream& operator<<(std::ostream& stream, const HandRank& a);
 
     static std::unordered_map<HandRank, std::string> HandRank_to_String {
@@ -48,8 +68,13 @@ namespace Poker {
         {HandRank::STRAIGHT_FLUSH, "Straight flush"}
     };
 
-    inline std::ostream& operator<<(std::ostream& stream, FullHandRank& a) { 
-      std::cout << HandRank_to_String[a.handrank] << " " << a.maincards << "| " << a.kickers;
+    inline std::ostream& operator<<(std::ostream& stream, const FullHandRank& a) { 
+        stream << HandRank_to_String[a.handrank()] << " ";
+        for(size_t i=0; i<5; i++) {
+            if( i == a.numMainRanks() ) stream << "| ";
+            const Rank r = a.rankAt(i);
+            if( r != Rank::UNDEF_RANK ) stream << rank_to_char_map[r] << " ";
+        }
         return stream;
     }
 
@@ -60,10 +85,10 @@ namespace Poker {
     inline void sortCards(std::vector<Card>& h);
     inline void sortCardsDescending(std::vector<Card>& h);
 
+    const FullHandRank calcFullHandRank(const CardSet& cards);
+    const FullHandRank calcFullHandRank(const Card* cards, const size_t n);
     const FullHandRank calcFullHandRank(const std::vector<Card>& hand_in);
 
-    const FullHandRank& showdownFHR(const FullHandRank& A, const FullHandRank& B);
-
 
 
     FullHandRank generateRandomFHR();
@@ -0,0 +1,39 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+namespace Poker {
+    class RunningStats {
+        // Streaming mean and variance (Welford), so sampling loops need O(1) memory.
+        // Two partial results merge exactly (Chan et al.), which lets every thread keep its own and reduce at the end
+        public:
+            void add(const double x) {
+                n++;
+                const double delta = x - mu;
+                mu += delta / n;
+                m2 += delta * (x - mu);
+            }
+            void merge(const RunningStats& o) {
+                if( o.n == 0 ) return;
+                if( n == 0 ) { *this = o; return; }
+                const uint64_t total = n + o.n;
+                const double delta = o.mu - mu;
+                mu += delta * o.n / total;
+                m2 += o.m2 + delta * delta * (double(n) * o.n / total);
+                n = total;
+            }
+            RunningStats& operator+=(const RunningStats& o) { merge(o); return *this; }
+
+            uint64_t count() const { return n; }
+            double mean() const { return mu; }
+            double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }        // sample variance
+            double populationVariance() const { return n > 0 ? m2 / n : 0.0; }
+            double stddev() const { return std::sqrt(variance()); }
+            double standardError() const { return n > 0 ? std::sqrt(variance() / n) : 0.0; }
+
+        private:
+            uint64_t n = 0;
+            double mu = 0.0;
+            double m2 = 0.0;
+    };
+}
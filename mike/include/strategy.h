@@ -3,6 +3,12 @@
 #include "table.h"
 #include "showdown.h"
 #include "bench.h"
+#include "rng.h"
+#include "infosettable.h"
+#include "strategyfile.h"
+#include "handbuckets.h"
+#include <any>
+#include <array>
 #include <map>
 #include <memory>
 #include <random>
@@ -14,27 +20,29 @@ namespace Poker {
     enum class Move;
     class Table;
     class Player;
+    class TableView;
     struct Strategy {
         public:
-            virtual PlayerMove makeMove(const std::shared_ptr<Table>, const shared_ptr<Player>);
-            template<typename... Args>
-                void updateParameters(Args&&... args) {
-                    updateParametersImpl(std::forward<Args>(args)...);
-                }
-        private:
-            template<typename... Args>
-                void updateParametersImpl(Args...) {};
+            Rng rng = newRngStream();       // every random choice the strategy makes comes from here
+            virtual PlayerMove makeMove(const TableView& info);      // info is only valid during the call
+            // Tuning parameters, as passed to the Monte Carlo drivers; strategies without any ignore them
+            virtual void updateParameters(const std::vector<std::any>&) {}
+            // Independent copy, so a table can be cloned and played on another thread
+            virtual std::shared_ptr<Strategy> clone() const { return std::make_shared<Strategy>(*this); }
+            virtual ~Strategy() = default;
     };
     struct RandomAI : public Strategy {
         public:
             // inherit the constructors from the Strategy struct
             using Strategy::Strategy;
-            PlayerMove makeMove(std::shared_ptr<Table> info, const shared_ptr<Player>) override;
+            PlayerMove makeMove(const TableView& info) override;
+            std::shared_ptr<Strategy> clone() const override { return std::make_shared<RandomAI>(*this); }
     };
     struct SingleMoveCallAI : public Strategy {
         public:
             using Strategy::Strategy;
-            PlayerMove makeMove(std::shared_ptr<Table> info, const shared_ptr<Player>) override;
+            PlayerMove makeMove(const TableView& info) override;
+            std::shared_ptr<Strategy> clone() const override { return std::make_shared<SingleMoveCallAI>(*this); }
     };
     struct SequenceMoveAI : public Strategy {
         // Strategy instance that follows a sequence of moves
@@ -45,7 +53,8 @@ namespace Poker {
                 index = 0;
                 moveList = vector<PlayerMove>();
             }
-            PlayerMove makeMove(std::shared_ptr<Table> info, const shared_ptr<Player>) override;
+            PlayerMove makeMove(const TableView& info) override;
+            std::shared_ptr<Strategy> clone() const override { return std::make_shared<SequenceMoveAI>(*this); }
     };
 
     struct MoveAwareAI : public Strategy {
@@ -53,7 +62,8 @@ namespace Poker {
         // only heads up games are supported
         public:
             using Strategy::Strategy;
-            PlayerMove makeMove(std::shared_ptr<Table> info, const shared_ptr<Player>) override;
+            PlayerMove makeMove(const TableView& info) override;
+            std::shared_ptr<Strategy> clone() const override { return std::make_shared<MoveAwareAI>(*this); }
             map<vector<Move>, int> moveSequenceToBet;
             vector<Move> enemyMoves;
     };
@@ -87,79 +97,86 @@ namespace Poker {
             Raise = 2,
             AllIn = 3
         };
-        struct BinnedPlayerMoveHash {
-            size_t operator()(const BinnedPlayerMove& pp) const {
-                return static_cast<size_t>(pp);
-            }
-        };
-        struct PlayerPositionHash {
-            size_t operator()(const PlayerPosition& pp) const {
-                return static_cast<size_t>(pp);
-            }
-        };
+        static constexpr int kNumPositions = 9;
+        static constexpr int kNumBinnedMoves = 4;           // Fold, Call, Raise, AllIn
+        static constexpr int kNumHandClasses = 256;         // the 8-bit hand class field of an infoset key
+        static_assert(kNumBinnedMoves == StrategyFile::kNumActions, "policy files hold one weight per binned move");
+        using InfosetKey = uint64_t;
 
         struct ReducedGameState {
             // (all players)
-            // Position, ReducedHandRank, street, and move history of all players
+            // Position, ReducedHandRank, street, and the last move of every seated player
             PlayerPosition position;
             ReducedFullHandRank RFHR;
             int street;
-            unordered_map<PlayerPosition, vector<BinnedPlayerMove>, PlayerPositionHash> playerHistory;
+            std::array<BinnedPlayerMove, kNumPositions> lastMove;
+            uint16_t seated = 0;                                        // bit p is set when position p is at the table
+            int handClass = -1;                                         // replaces the class derived from RFHR when set, e.g. a HandBuckets bucket
 
-            bool operator==(const ReducedGameState& other) const {
-                return position == other.position &&
-                        int(RFHR) == int(other.RFHR) &&
-                        street == other.street &&
-                        playerHistory == other.playerHistory;
-            }
-        };
-        // Need the hash for the unordered_map
-        struct RGSHash {
-            size_t operator()(const ReducedGameState& rgs) const {
-                size_t hash = 0;
-                hashCombine(hash, rgs.position);
-                hashCombine(hash, int(rgs.RFHR));
-                hashCombine(hash, rgs.street);
-                for(const auto& pair : rgs.playerHistory) {
-                    hashCombine(hash, pair.first);
-                    for(const auto& v : pair.second) {
-                        hashCombine(hash, v);
-                    }
-                }
-                return hash;
-            }
+            bool operator==(const ReducedGameState& other) const { return key() == other.key(); }
+
+            // Packed into 42 bits: position (4), street (3), hand class (8), then 3 bits per position
+            // holding 0 for an empty seat or the move + 2
+            InfosetKey key() const;
+            static ReducedGameState fromKey(const InfosetKey key);      // decodes the hand class as a RFHR
         };
 
-        ReducedGameState packTableIntoReducedGameState(Table table);
+        // The hand class in the key: handrank * 14 + main rank + 1, or the hand's bucket where buckets cover the street
+        static int handClassOf(const ReducedFullHandRank& r);
+        static int handClassOf(const CardSet& hole, const CardSet& board, const HandBuckets* buckets);
+
+        ReducedGameState packTableIntoReducedGameState(const TableView& view);     // the state as the acting player sees it
         BinnedPlayerMove packBinnedPlayerMove(PlayerMove m);
-        PlayerMove unpackBinnedPlayerMove(BinnedPlayerMove m, int minimumBet, int bankroll);
+        static PlayerMove unpackBinnedPlayerMove(BinnedPlayerMove m, int minimumBet, int bankroll);
         using Strategy::Strategy;
-        PlayerMove makeMove(std::shared_ptr<Table> info, const shared_ptr<Player>) override;
-        unordered_map<ReducedGameState, map<BinnedPlayerMove, float>, RGSHash> CFRTable;       // Maps between the game state and probability to make each move
-
+        PlayerMove makeMove(const TableView& info) override;
+        std::shared_ptr<Strategy> clone() const override { return std::make_shared<CFRAI1>(*this); }
+        InfosetTable<kNumBinnedMoves> CFRTable;         // Maps between the game state and the weight of each move, indexed by BinnedPlayerMove
+        std::shared_ptr<const StrategyFile> policyFile;    // loaded policy, consulted before CFRTable; shared by copies of this AI
+        std::shared_ptr<const HandBuckets> handBuckets;    // card abstraction the policy was trained with, if not ReducedFullHandRank
+
+        // Binary StrategyFile format; dump overwrites outfile, load maps infile and throws if it isn't a valid policy.
+        // A policy file records its hand buckets, so load them before a bucketed policy: either load throws when the
+        // buckets and the policy don't match, including a bucketed policy without buckets and the other way round
         void dumpCFRTableToFile(std::string outfile);
         void loadCFRTableFromFile(std::string infile);
-
-        template <typename T>
-        static void hashCombine(size_t& seed, const T& v) {
-            hash<T> hasher;
-            seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        }
+        void loadHandBucketsFromFile(std::string infile);         // throws if it isn't a valid HandBuckets file
     };
 
 
     struct MattAI : public Strategy {
         public:
             using Strategy::Strategy;
-            PlayerMove makeMove(std::shared_ptr<Table> info, const shared_ptr<Player>) override;
+            PlayerMove makeMove(const TableView& info) override;
+            std::shared_ptr<Strategy> clone() const override { return std::make_shared<MattAI>(*this); }
             std::vector<double> thresholds = {0.2, 0.7, 0.9};
-      private:
-            void updateParametersImpl(std::vector<double>);
+            double equityTolerance = 0.02;      // sampling also stops early once the estimate is clear of every threshold
+            uint64_t equitySamples = 4096;      // at most this many deals are sampled
+            void updateParameters(const std::vector<std::any>& params) override;       // the thresholds, as doubles
     };
 
 
 
 
+    struct ISMCTSAI : public Strategy {
+        // Information set Monte Carlo tree search (Cowling, Powley & Whitehouse, SO-ISMCTS) over the game engine.
+        // Every iteration deals the opponents hole cards the player can't see, then walks one tree of the player's
+        // binned moves and everybody else's, pooled over all those deals and over the board cards still to come:
+        // UCB1 with availability counts while the tree covers the hand, one new node, then everyone checks or calls
+        // to the showdown. Each node's moves are scored in big blinds won by the seat that makes them.
+        // Searches until secondsPerMove runs out (or maxIterations), one tree per thread, and plays the root move the
+        // trees visited most. Outside a Game (TableView::handState false) it just calls
+        public:
+            using Strategy::Strategy;
+            PlayerMove makeMove(const TableView& info) override;
+            std::shared_ptr<Strategy> clone() const override { return std::make_shared<ISMCTSAI>(*this); }
+            double secondsPerMove = 0.05;
+            uint64_t maxIterations = 0;         // per decision over all trees, 0 for no limit; without a time limit a seeded search is reproducible for a given number of trees
+            int threads = 0;                    // trees searched in parallel, 0 for one per pool thread
+            double exploration = 2.0;           // UCB1 constant, in big blinds
+            void updateParameters(const std::vector<std::any>& params) override;       // secondsPerMove then exploration, as doubles
+    };
+
     
     inline std::string getAIName(shared_ptr<Strategy> &a) { 
         return "default";
@@ -171,7 +188,4 @@ namespace Poker {
         return "sequence";
     }
 
-
-    static PlayerMove betAmountToMove(int betAmount, shared_ptr<Table>& info, const shared_ptr<Player>& p);
-
 }
\ No newline at end of file
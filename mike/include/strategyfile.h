@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "infosettable.h"
+
+namespace Poker {
+    class StrategyFile {
+        // Read-only CFR policy on disk: a small header, then fixed-size entries sorted by infoset key.
+        // open() maps the file (mmap where available) and find() binary-searches the mapped entries in place, so
+        // there is no parse step and every process using the same file shares its pages.
+        // Native little-endian like PreflopTable; the header carries a version, an FNV-1a checksum of the entries and
+        // the fingerprint of the hand buckets the policy was trained with, as its infoset keys mean nothing under others
+        public:
+            static constexpr uint32_t kVersion = 2;
+            static constexpr int kNumActions = 4;           // BinnedPlayerMove order
+            struct Entry {
+                uint64_t key;
+                float values[kNumActions];
+            };
+
+            // Writes every entry of table, sorted, for buckets (a HandBuckets::fingerprint); false if the file can't be written
+            static bool write(const std::string& path, const InfosetTable<kNumActions>& table, const uint64_t buckets);
+
+            StrategyFile() = default;
+            StrategyFile(const StrategyFile&) = delete;
+            StrategyFile& operator=(const StrategyFile&) = delete;
+            ~StrategyFile() { close(); }
+
+            // false, leaving nothing open, if the file is missing, truncated or of another version. Only the header is
+            // read, so opening is instant and pages load as lookups touch them; with verify the checksum is checked too
+            bool open(const std::string& path, const bool verify = false);
+            bool verify() const;            // hashes every entry against the header's checksum, reading the whole file
+            void close();
+            bool isOpen() const { return entries != nullptr; }
+
+            size_t size() const { return numEntries; }
+            uint64_t bucketFingerprint() const { return buckets; }
+            const Entry* begin() const { return entries; }
+            const Entry* end() const { return entries + numEntries; }
+            const Entry* find(const uint64_t key) const;     // nullptr if absent
+
+        private:
+            const Entry* entries = nullptr;
+            size_t numEntries = 0;
+            uint64_t checksum = 0;
+            uint64_t buckets = 0;
+            void* mapping = nullptr;        // what close() releases
+            size_t mappingSize = 0;
+    };
+}
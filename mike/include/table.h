@@ -4,6 +4,7 @@
 #include <algorithm>
 
 #include "card.h"
+#include "rng.h"
 #include "strategy.h"
 #include "player.h"
 using namespace std;
@@ -11,33 +12,37 @@ namespace Poker {
 
     class Player;
     enum class PlayerPosition;
+    class Game;
     class Table {
+        friend class Game;                      // snapshots and restores the deck
         private:
             Deck deck;
         public:
-            shared_ptr<random_device> rd;
+            Rng rng = newRngStream();                   // the deck draws from this; copies of a Table deal the same cards
             // playerList contains Player classes which by default call every time
             // Overload the virtual function makeMove to define new behavior
             vector<shared_ptr<Player>> playerList;
             
-            vector<Card> communityCards;
+            CardSet communityCards;
             int                 street              = 0;                // phase of the game. 0 = preflop, 1 = flop, 2 = turn, 3 = river
             int                 bigBlind            = 10;
             int                 smallBlind          = 5;
             int                 pot                 = 0;
             int                 minimumBet          = 0;
             shared_ptr<Deck>   getDeck();
+            Table clone() const;                        // deep copy: players and strategies are copied rather than shared
             void setPlayerList(const vector<string> sVec);
-            void resetCards(random_device& );
+            void resetCards();
+            void resetDeck(const CardSet& dead = CardSet());       // back to the unshuffled deck without the dead cards, so the same rng state deals the same cards
             void dealCommunityCards(int );
-            void dealPlayersCards(const std::vector<shared_ptr<Player>>);
+            void dealPlayersCards(const std::vector<shared_ptr<Player>>&);
             void clearPlayerHands();
             void setPlayerBankrolls(int n = 100);
+            void sortInBettingOrder(vector<shared_ptr<Player>>& players) const;
             vector<shared_ptr<Player>> getPlayersInBettingOrder(vector<shared_ptr<Player>> in = vector<shared_ptr<Player>>());
 
             bool arePlayerPositionsValid(const vector<shared_ptr<Player>>& pList);
 
-            void shuffleDeck();
-            shared_ptr<Player> getPlayerByID(const int& id);
+            shared_ptr<Player> getPlayerByID(const int& id) const;
     };
 }
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include "card.h"
+#include "gamestate.h"
+#include "player.h"
+#include "table.h"
+
+namespace Poker {
+    class TableView {
+        // What a strategy sees when it is asked to act: the public state of the table and its own player.
+        // It refers to the live Table and Player rather than copying them, so making one costs nothing,
+        // and it is only valid for the makeMove call it was made for. Other seats show no hole cards
+        public:
+            struct Seat {
+                int playerID;
+                PlayerPosition position;
+                int bankroll;                   // stack at the start of the hand
+                PlayerMove move;                // last move; bet_amount is what the seat has committed this hand
+            };
+
+            // hand is the engine state of the Game asking, nullptr outside one
+            TableView(const Table& table, const Player& self, const GameState* hand = nullptr) : table(table), me(self), hand(hand) {}
+
+            int street() const { return table.street; }
+            int pot() const { return table.pot; }
+            int minimumBet() const { return table.minimumBet; }
+            int bigBlind() const { return table.bigBlind; }
+            int smallBlind() const { return table.smallBlind; }
+            const CardSet& communityCards() const { return table.communityCards; }
+            // The engine's state of the hand with every hole card but the player's own removed, in out; false outside a Game
+            bool handState(GameState& out) const {
+                if( !hand ) return false;
+                out = *hand;
+                for(int seat = 0; seat < out.numSeats; seat++)
+                    if( out.hole[seat] != me.hand ) out.hole[seat].clear();
+                return true;
+            }
+
+            const Player& self() const { return me; }          // the acting player, hand included
+
+            size_t numSeats() const { return table.playerList.size(); }
+            Seat seat(const size_t i) const { return seatOf(*table.playerList[i]); }
+            Seat seatByID(const int id) const { return seatOf(*table.getPlayerByID(id)); }
+            template<typename F>
+                void forEachSeat(F&& f) const {
+                    for(const shared_ptr<Player>& p : table.playerList) f(seatOf(*p));
+                }
+
+        private:
+            const Table& table;
+            const Player& me;
+            const GameState* hand;          // seat i is the Game's bettingPlayers[i]
+
+            static Seat seatOf(const Player& p) { return Seat { p.playerID, p.position, p.bankroll, p.move }; }
+    };
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "rng.h"
+
+namespace Poker {
+    class ThreadPool {
+        // Work-stealing pool shared by every parallel loop in the program
+        // Each worker owns a deque: it takes work from the back, idle workers steal from the front of the others.
+        // A thread waiting in parallelFor runs queued tasks itself, so a chunk may start its own parallelFor
+        // (a simulated MattAI estimating equity inside a parallel game loop) without deadlocking the pool.
+        public:
+            explicit ThreadPool(unsigned numThreads);       // numThreads counts the calling thread
+            ~ThreadPool();
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            // Process-wide pool with POKER_THREADS threads, or one per hardware thread if unset
+            static ThreadPool& instance();
+            unsigned concurrency() const { return workers.size() + 1; }
+
+            // Runs f(chunk) for every chunk in [0, nChunks) and returns once all of them are done.
+            // The first exception thrown by a chunk is rethrown here
+            template<typename F>
+            void parallelFor(const size_t nChunks, F&& f);
+
+            // True while the calling thread runs a chunk of some parallelFor. A loop started from there waits by
+            // running whatever else is queued, so work with a deadline should run inline instead
+            static bool inParallelFor() { return chunkDepth > 0; }
+
+        private:
+            struct ChunkScope {
+                ChunkScope() { chunkDepth++; }
+                ~ChunkScope() { chunkDepth--; }
+            };
+            static thread_local int chunkDepth;
+
+            struct Queue {
+                std::mutex lock;
+                std::deque<std::function<void()>> tasks;
+            };
+            std::vector<std::thread> workers;
+            std::vector<std::unique_ptr<Queue>> queues;     // one per worker, the last is shared by outside threads
+            std::atomic<size_t> pending { 0 };              // tasks sitting in the queues
+            std::atomic<bool> stopping { false };
+            std::mutex sleepLock;
+            std::condition_variable wake;
+
+            size_t homeQueue() const;
+            void push(std::function<void()> task);
+            void notifyWorkers();
+            bool runOne();
+            void workerLoop(const size_t index);
+    };
+
+    template<typename F>
+    void ThreadPool::parallelFor(const size_t nChunks, F&& f) {
+        if( nChunks == 0 ) return;
+        if( nChunks == 1 or workers.empty() ) {
+            const ChunkScope scope;
+            for(size_t c = 0; c < nChunks; c++) f(c);
+            return;
+        }
+
+        std::atomic<size_t> remaining { nChunks };
+        std::exception_ptr error;
+        std::mutex errorLock;
+        auto runChunk = [&](const size_t c) {
+            const ChunkScope scope;
+            try { f(c); }
+            catch(...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if( !error ) error = std::current_exception();
+            }
+            remaining.fetch_sub(1, std::memory_order_release);
+        };
+
+        for(size_t c = 1; c < nChunks; c++)
+            push([&runChunk, c]() { runChunk(c); });
+        notifyWorkers();
+
+        runChunk(0);
+        while( remaining.load(std::memory_order_acquire) > 0 )
+            if( !runOne() ) std::this_thread::yield();
+
+        if( error ) std::rethrow_exception(error);
+    }
+
+    template<typename Result, typename F>
+    std::vector<Result> runInChunks(const uint64_t N, const uint64_t perChunk, Rng& rng, F&& f) {
+        // Splits N samples into chunks run on the shared pool; f(chunkRng, n) returns the result of n samples.
+        // Every chunk gets its own stream split off rng and writes only its own result slot.
+        // The chunking depends on N alone, so a seeded run gives the same answer on any number of threads
+        constexpr uint64_t kMaxChunks = 1024;
+        const size_t nChunks = std::clamp<uint64_t>(N / perChunk, 1, kMaxChunks);
+        std::vector<Result> results(nChunks);
+        if( nChunks == 1 ) {
+            results[0] = f(rng, N);
+            return results;
+        }
+        std::vector<Rng> streams;
+        streams.reserve(nChunks);
+        for(size_t c = 0; c < nChunks; c++)
+            streams.emplace_back(rng.split());
+        ThreadPool::instance().parallelFor(nChunks, [&](const size_t c) {
+            results[c] = f(streams[c], N * (c + 1) / nChunks - N * c / nChunks);
+        });
+        return results;
+    }
+}
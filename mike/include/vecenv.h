@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game.h"
+#include "gamestate.h"
+#include "strategy.h"
+
+namespace Poker {
+    class VecEnv {
+        // numEnvs independent tables stepped in lockstep for reinforcement learning, Gym VecEnv style.
+        // Player 0 of every table is the agent, an external player; the other seats are played by the named strategies.
+        // Every hand starts with fresh stacks and the seats rotated one position, and runs on Game's own rules,
+        // Game::advanceToDecision playing the opponents until the agent has to act again.
+        // Actions are CFRAI1::BinnedPlayerMove values. Observations, legal-action masks, rewards and done flags
+        // live in buffers owned by the environment that step overwrites in place; a finished hand is reported
+        // through its reward and done flag and a new one is dealt at once, so the observation is already the next hand's
+        public:
+            struct Settings {
+                int numEnvs = 16;
+                std::vector<std::string> opponents = { "call" };     // AI names of seats 1.., as Table::setPlayerList takes them
+                int stack = 100;                                      // every seat's bankroll at the start of each hand
+                int smallBlind = 5;
+                int bigBlind = 10;
+                uint64_t seed = 1;
+            };
+            static constexpr int kNumActions = CFRAI1::kNumBinnedMoves;
+            // Observation layout, chip amounts in big blinds:
+            //   [0, 52)     hole cards, one-hot by card code (4 * rank + suit, as the batch functions encode cards)
+            //   [52, 104)   board cards, the same way
+            //   [104, 108)  street, one-hot
+            //   [108, 113)  pot, minimum bet, amount to call, chips behind, chips committed
+            //   [113, 167)  per position (PlayerPosition order): seated, is the agent, folded, all-in, committed, chips behind
+            static constexpr int kPerSeatFeatures = 6;
+            static constexpr int kObservationSize = 52 + 52 + 4 + 5 + GameState::kMaxSeats * kPerSeatFeatures;
+
+            VecEnv() : VecEnv(Settings()) {}
+            explicit VecEnv(const Settings& settings);
+
+            void reset();                                   // deals a new hand at every table
+            // actions[i] is the agent's move at table i; throws std::invalid_argument, changing nothing, if one is not legal
+            void step(const int32_t* actions);
+
+            int numEnvs() const { return settings.numEnvs; }
+            float* observations() { return obs.data(); }           // numEnvs x kObservationSize
+            uint8_t* masks() { return mask.data(); }               // numEnvs x kNumActions, 1 where the action is legal
+            float* rewards() { return reward.data(); }             // agent's result of the hand that just ended, in big blinds
+            uint8_t* dones() { return done.data(); }               // 1 where the last step ended a hand
+
+        private:
+            struct Env {
+                Game game;
+                uint64_t hands = 0;             // dealt so far, which sets the seat rotation
+            };
+            Settings settings;
+            std::vector<Env> envs;
+            std::vector<float> obs;
+            std::vector<uint8_t> mask;
+            std::vector<float> reward;
+            std::vector<uint8_t> done;
+
+            void startHand(const size_t i);
+            void observe(const size_t i);
+            bool legal(const size_t i, const int action) const { return action >= 0 and action < kNumActions and mask[i * kNumActions + action]; }
+    };
+}
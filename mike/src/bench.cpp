@@ -1,36 +1,65 @@
 #include "bench.h"
 #include "showdown.h"
+#include "evaluator.h"
+#include "equity.h"
+#include "stats.h"
 #include "table.h"
 #include "player.h"
 #include "game.h"
 #include "strategy.h"
 #include "pybindings.h"
+#include "threadpool.h"
 #include <chrono>
 #include <any>
 #include <fstream>
 #include <sstream>
+#include <numeric>
 
 namespace Poker {
+  namespace {
+    constexpr uint64_t kHandsPerChunk = 2048;
+
+    Table makeTable(const std::multimap<std::string, std::vector<std::any>>& aiInfo) {
+        // Fresh table whose players are built from (AI type string, AI parameters) pairs
+        auto myTable = Table();
+        std::vector<string> aiStrings;
+        std::vector<std::vector<std::any>> aiParams;
+        for(auto& pair : aiInfo) {
+          aiStrings.emplace_back(std::get<0>(pair));
+          aiParams.emplace_back(std::get<1>(pair));
+        }
+        myTable.setPlayerList(aiStrings);
+        for( int i=0; i<aiStrings.size(); i++ ) {
+          // Table is filled according to same order as aiStrings
+          auto p = myTable.getPlayerByID(i);
+          p->strategy->updateParameters(aiParams[i]);
+        }
+        // set blind amounts
+        myTable.bigBlind = 10;
+        myTable.smallBlind = 5;
+        return myTable;
+    }
+  }
+
   void benchmarkHandRankCalculator(const uint64_t& N) {
       auto start = std::chrono::steady_clock::now();
-      FullHandRank lastHand;
+      HandStrength bestStrength = 0;
+      CardSet bestCards;
+      Rng& rng = threadRng();
+      Deck newdeck;
       for(int iN = 0; iN < N; iN++) {
-          Deck newdeck;
-          newdeck.shuffle();          
-          std::vector<Card> cards(7);
-          for(short j=0; j<7; j++)
-              cards[j]=newdeck.pop_card();
-          FullHandRank FHR = calcFullHandRank(cards);
-          if( iN == 0 ) lastHand = FHR;
-          else {
-              if( showdownFHR(lastHand, FHR) == FHR  )    { 
-                  lastHand = FHR;
-              }
-          }   
+          newdeck.reset();
+          const CardSet cards = newdeck.pop_cards(rng, 7);
+          const HandStrength strength = evaluateHand(cards);
+          if( strength > bestStrength ) {
+              bestStrength = strength;
+              bestCards = cards;
+          }
       }
       std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+      FullHandRank lastHand = decodeHandStrength(bestStrength);
       std::cout << "Best hand: " << std::endl;
-      std::cout << lastHand.handrank << " " << lastHand.maincards << "| " << lastHand.kickers << std::endl;
+      std::cout << bestCards << "= " << lastHand << std::endl;
       std::cout << N << " hands calculated in " << duration.count() << " seconds, or " << double(N)/duration.count() << " hands/second" << std::endl;
   }
 
@@ -47,7 +76,7 @@ namespace Poker {
     std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
     //std::cout << "Best hand: " << std::endl;
     //std::cout << "Player " << bestPlayer->playerID  << " " << PlayerPosition_to_String[bestPlayer->getPosition()]
-    //        << " " << bestPlayer->FHR.handrank << " " << bestPlayer->FHR.maincards << "| " << bestPlayer->FHR.kickers << std::endl;
+    //        << " " << bestPlayer->FHR << std::endl;
     std::cout << N << " rounds calculated in " << duration.count() << " seconds, or " << double(N)/duration.count() << " rounds/second" << std::endl;
   }
 
@@ -82,268 +111,228 @@ void monteCarloGameStateCompare() {
 std::tuple<double, double> monteCarloRounds(const uint64_t& N, const std::multimap<std::string, std::vector<std::any>>& aiInfo) {
     // input: N games, vector of tuples ( Ai type string, ai parameters )
     // Returns (avg win rate, variance of win rate) of player 0
-    // Create Table and fill AI List
-    auto myTable = Table();
-    std::vector<string> aiStrings;
-    std::vector<std::vector<std::any>> aiParams;
-    for(auto& pair : aiInfo) {
-      aiStrings.emplace_back(std::get<0>(pair));
-      aiParams.emplace_back(std::get<1>(pair));
-    }
-    myTable.setPlayerList(aiStrings);
-    for( int i=0; i<aiStrings.size(); i++ ) {
-      // Table is filled according to same order as aiStrings
-      auto p = myTable.getPlayerByID(i);
-      p->strategy->updateParameters(aiParams[i]);
-    }
-
-    // now begin games part
-    std::random_device rd;
-    // set blind amounts
-    myTable.bigBlind = 10;
-    myTable.smallBlind = 5;
-
-    auto game = std::make_shared<Game>(myTable);
-    vector<int> pZeroWinnings (N);
-    int startingCash = 100;
-
-    int iN = 0;
-    while( iN < N ) {
-      // Resets game, does a single round, tallies winnings
-      // Does not change player positions
-      game->table.setPlayerBankrolls(startingCash);
-      game->setup();
-      game->table.resetCards(rd);
-      game->doRound();  
-      iN++;
-      pZeroWinnings[iN] = (game->table.getPlayerByID(0)->bankroll - startingCash)/myTable.bigBlind; // dimensionless winnings
-    }
-
-
-    double avgReturn = 0.0;
-    for( const auto& w : pZeroWinnings )
-        avgReturn += w;
-    avgReturn /= N;
-    double sigmaReturn = 0.0;
-    for( const auto& w : pZeroWinnings ) {
-        const auto tmp = double(w) - avgReturn;
-        sigmaReturn += tmp*tmp;
-    }
-    sigmaReturn /= N;
-    sigmaReturn = sqrt(sigmaReturn);
+    // Every chunk plays on its own clone of the table, so strategies that learn as they play only see their chunk's rounds
+    const int startingCash = 100;
+    const Table prototype = makeTable(aiInfo);
+    const auto chunks = runInChunks<RunningStats>(N, 64, threadRng(), [&](Rng& rng, const uint64_t n) {
+        Game game(prototype.clone());
+        game.seed(rng());
+        const Player& playerZero = *game.table.getPlayerByID(0);
+        RunningStats winnings;
+        for(uint64_t iN = 0; iN < n; iN++) {
+          // Resets game, does a single round, tallies winnings
+          // Does not change player positions
+          game.table.setPlayerBankrolls(startingCash);
+          game.setup();
+          game.doRound();
+          winnings.add(double(playerZero.bankroll - startingCash)/game.table.bigBlind); // dimensionless winnings
+        }
+        return winnings;
+    });
+
+    RunningStats total;
+    for(const RunningStats& w : chunks)
+        total += w;
+    const double avgReturn = total.mean();
+    const double sigmaReturn = sqrt(total.populationVariance());
     return std::make_tuple(avgReturn, sigmaReturn);
 }
 
 
 std::tuple<double, double> monteCarloGames(const uint64_t& N, const std::multimap<std::string, std::vector<std::any>>& aiInfo) {
-    // Create Table and fill AI List
-    auto myTable = Table();
-    // unpack AI list
-    std::vector<string> aiStrings;
-    std::vector<std::vector<std::any>> aiParams;
-    for(auto& pair : aiInfo) {
-      aiStrings.emplace_back(std::get<0>(pair));
-      aiParams.emplace_back(std::get<1>(pair));
-    }
-    
-    myTable.setPlayerList(aiStrings);
-    for( int i=0; i<aiStrings.size(); i++ ) {
-      // Table is filled according to same order as aiStrings
-      auto p = myTable.getPlayerByID(i);
-      p->strategy->updateParameters(aiParams[i]);
-    }
-    std::random_device rd;
-    // set blind amounts
-    myTable.bigBlind = 10;
-    myTable.smallBlind = 5;
+    // Returns (fraction of games won, its standard deviation) of player 0
+    const int startingCash = 100;
+    const Table prototype = makeTable(aiInfo);
+    const auto chunks = runInChunks<RunningStats>(N, 8, threadRng(), [&](Rng& rng, const uint64_t n) {
+        Game game(prototype.clone());
+        game.seed(rng());
+        const shared_ptr<Player> playerZero = game.table.getPlayerByID(0);
+        RunningStats wins;
+        for(uint64_t iN = 0; iN < n; iN++) {
+            game.table.setPlayerBankrolls(startingCash);
+            game.setup();
+            game.doGame();
+            wins.add(game.lastRoundWinner == playerZero ? 1.0 : 0.0);
+        }
+        return wins;
+    });
+
+    RunningStats total;
+    for(const RunningStats& w : chunks)
+        total += w;
+    const double avgReturn = total.mean();
+    const double sigmaReturn = sqrt(total.populationVariance());
+    return std::make_tuple(avgReturn, sigmaReturn);
+}
 
-    auto game = std::make_shared<Game>(myTable);
 
-    // setup some statistics
-    vector<int> pZeroWinnings (N);
+namespace {
+    template<typename Play>
+    DuplicateResult duplicateDeals(const uint64_t N, const uint64_t perChunk, const std::vector<std::vector<std::any>>& candidates,
+                                   const std::multimap<std::string, std::vector<std::any>>& aiInfo, Play&& play) {
+        // play(game, playerZero) plays one replay of the deal the game was just seeded with and returns player 0's result
+        if( candidates.empty() ) throw std::invalid_argument("duplicate evaluation needs at least one candidate");
+        const Table prototype = makeTable(aiInfo);
+        const int nPlayers = prototype.playerList.size();
+        if( nPlayers < 2 or nPlayers > GameState::kMaxSeats ) throw std::invalid_argument("duplicate evaluation needs 2 to 9 players");
+        const std::vector<PlayerPosition>& positions = positionsInBettingOrder(nPlayers);
+
+        const auto chunks = runInChunks<DuplicateResult>(N, perChunk, threadRng(), [&](Rng& rng, const uint64_t n) {
+            std::vector<Game> games;
+            games.reserve(candidates.size());
+            for(const std::vector<std::any>& params : candidates) {
+                games.emplace_back(prototype.clone());
+                games.back().table.getPlayerByID(0)->strategy->updateParameters(params);
+            }
+            DuplicateResult result;
+            result.winnings.resize(candidates.size());
+            result.difference.resize(candidates.size());
+            for(uint64_t iN = 0; iN < n; iN++) {
+                const uint64_t dealSeed = rng();
+                double baseline = 0.0;
+                for(size_t c = 0; c < games.size(); c++) {
+                    Game& game = games[c];
+                    double total = 0.0;
+                    for(int rotation = 0; rotation < nPlayers; rotation++) {
+                        // player i sits where player i + rotation sat in the first replay, and is dealt that seat's cards
+                        for(const shared_ptr<Player>& P : game.table.playerList)
+                            P->setPosition(positions[(P->playerID + rotation) % nPlayers]);
+                        game.seed(dealSeed);
+                        game.table.resetDeck();
+                        total += play(game, *game.table.getPlayerByID(0));
+                    }
+                    const double value = total / nPlayers;
+                    if( c == 0 ) baseline = value;
+                    result.winnings[c].add(value);
+                    result.difference[c].add(value - baseline);
+                }
+            }
+            return result;
+        });
+
+        DuplicateResult total;
+        total.winnings.resize(candidates.size());
+        total.difference.resize(candidates.size());
+        for(const DuplicateResult& chunk : chunks)
+            for(size_t c = 0; c < candidates.size(); c++) {
+                total.winnings[c] += chunk.winnings[c];
+                total.difference[c] += chunk.difference[c];
+            }
+        return total;
+    }
+}
 
-    auto start = std::chrono::steady_clock::now();
-    int iT = 0;
-    int totalRounds = 0;
+DuplicateResult monteCarloDuplicateRounds(const uint64_t& N, const std::vector<std::vector<std::any>>& candidates, const std::multimap<std::string, std::vector<std::any>>& aiInfo) {
     const int startingCash = 100;
-    for(int iN = 0; iN < N; iN++) {
-        game->table.setPlayerBankrolls(startingCash);
-        game->setup();
-        game->doGame();
-        //pZeroWinnings[iN] = (game->table.getPlayerByID(0)->bankroll - startingCash)/myTable.bigBlind; // dimensionless winnings
-        pZeroWinnings[iN] = game->lastRoundWinner == game->table.getPlayerByID(0) ? 1 : 0;
-        totalRounds+=game->nRounds;
-    }
+    return duplicateDeals(N, 16, candidates, aiInfo, [](Game& game, const Player& playerZero) {
+        game.table.setPlayerBankrolls(startingCash);
+        game.setup();
+        game.doRound();
+        return double(playerZero.bankroll - startingCash)/game.table.bigBlind;
+    });
+}
 
-    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
-    //std::cout << N << " games (" << totalRounds << " rounds) calculated in " << duration.count() << " seconds, or " 
-    //<< double(N)/duration.count() << " games/s (" << double(totalRounds)/duration.count() << " rounds/s)" << std::endl;
-
-    double avgReturn = 0.0;
-    for( const auto& w : pZeroWinnings )
-        avgReturn += w;
-    avgReturn /= N;
-    double sigmaReturn = 0.0;
-    for( const auto& w : pZeroWinnings ) {
-        const auto tmp = double(w) - avgReturn;
-        sigmaReturn += tmp*tmp;
-    }
-    sigmaReturn /= N;
-    sigmaReturn = sqrt(sigmaReturn);
-    return std::make_tuple(avgReturn, sigmaReturn);
+DuplicateResult monteCarloDuplicateGames(const uint64_t& N, const std::vector<std::vector<std::any>>& candidates, const std::multimap<std::string, std::vector<std::any>>& aiInfo) {
+    const int startingCash = 100;
+    return duplicateDeals(N, 2, candidates, aiInfo, [](Game& game, const Player& playerZero) {
+        game.table.setPlayerBankrolls(startingCash);
+        game.setup();
+        game.doGame();
+        return game.lastRoundWinner.get() == &playerZero ? 1.0 : 0.0;
+    });
 }
 
 
 std::tuple<double,double> monteCarloSingleHand(const std::vector<Card>& cardsA, const int numCommCards, const int numOtherPlayers, const uint64_t N) {
-    std::random_device rd;
-    std::vector<short> outcomes(N, 0);
-
-    uint64_t winCountA = 0;
-    std::vector<std::vector<Card>> otherPlayerCards(numOtherPlayers);
-    
-    auto start = std::chrono::steady_clock::now();
-    winCountA = 0;
-    for(int iN = 0; iN < N; iN++) {
-        std::mt19937_64 g(rd());
-        std::vector<Card> communityCards(numCommCards);
-        std::vector<Card> cardsAMutable(cardsA);
-        //make new deck without players' cards
-        Deck newdeck(cardsA);
-        newdeck.shuffle();
-        // deal community cards
-        for(short j=0; j<numCommCards; j++)
-            communityCards[j]=newdeck.pop_card();
-        // deal other player's cards
-        for( auto& v : otherPlayerCards ) {
-            v.clear();
-            v.emplace_back( newdeck.pop_card() );
-            v.emplace_back( newdeck.pop_card() );
-            v.insert(v.end(), communityCards.begin(), communityCards.end());
-        }
-        cardsAMutable.insert(cardsAMutable.end(), communityCards.begin(), communityCards.end());
-
-        const FullHandRank fhrA = calcFullHandRank(cardsAMutable);
-        bool aWins = true;
-        for(auto& v : otherPlayerCards) {
-            auto otherGuyFHR = calcFullHandRank(v);
-            auto showdownResult = showdownFHR(fhrA, otherGuyFHR);
-            if( showdownResult == otherGuyFHR ) aWins = false;
-        }
-        
-        if( aWins ) {
-            winCountA++;
-            outcomes[iN] = 1;
+    const CardSet holeA(cardsA);
+    const auto wins = runInChunks<uint64_t>(N, kHandsPerChunk, threadRng(), [&](Rng& rng, const uint64_t n) {
+        Deck newdeck;
+        uint64_t winCountA = 0;
+        for(uint64_t iN = 0; iN < n; iN++) {
+            // put back everything but the player's cards
+            newdeck.reset(holeA);
+            // deal community cards
+            const CardSet communityCards = newdeck.pop_cards(rng, numCommCards);
+            const HandStrength strengthA = evaluateHand(holeA | communityCards);
+
+            // deal other player's cards
+            bool aWins = true;
+            for(int p=0; p<numOtherPlayers; p++) {
+                const CardSet otherHand = communityCards | newdeck.pop_cards(rng, 2);
+                if( evaluateHand(otherHand) > strengthA ) aWins = false;
+            }
+            if( aWins ) winCountA++;
         }
-    }
+        return winCountA;
+    });
 
-    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
-    const double winRateA = double(winCountA)/N;
-    //std::cout << "A winrate: " << winRateA*100.0 << "%" << std::endl;
-    //std::cout << N << " hands calculated in " << duration.count() << " seconds, or " << double(N)/duration.count() << " hands/second" << std::endl;
-    double sigma = 0.0;
-    for(auto& e : outcomes)
-        sigma += (e - winRateA)*(e - winRateA);
-    sigma /= N;
-    sigma = sqrt(sigma);
+    const double winRateA = double(std::accumulate(wins.begin(), wins.end(), uint64_t(0)))/N;
+    // outcomes are 0 or 1, so the standard deviation follows from the win rate
+    const double sigma = sqrt(winRateA*(1.0 - winRateA));
     return std::make_tuple(winRateA, sigma);
 }
 
 
 
 std::tuple<double,double> monteCarloSingleHand(const std::vector<Card>& cardsA, const std::vector<Card>& commCards, const int numOtherPlayers, const uint64_t N) {
-    // returns Avg win rate and standard deviation
-    std::vector<short> outcomes(N, 0);
-    uint64_t winCountA = 0;
-    std::vector<std::vector<Card>> otherPlayerCards(numOtherPlayers);
-
-    std::vector<Card> cardsUnion (cardsA);
-    cardsUnion.insert(cardsUnion.end(), commCards.begin(), commCards.end());
-    
-    const FullHandRank fhrA = calcFullHandRank(cardsUnion);
-
-    std::random_device rd;
-    for(int iN = 0; iN < N; iN++) {
-        //make new deck without players' cards
-        Deck newdeck(cardsUnion);
-        newdeck.setSeed(rd());
-        newdeck.shuffle();
-        // deal other player's cards
-        for( auto& v : otherPlayerCards ) {
-            v.clear();
-            v.emplace_back( newdeck.pop_card() );
-            v.emplace_back( newdeck.pop_card() );
-            v.insert(v.end(), commCards.begin(), commCards.end());
-        }
+    return monteCarloSingleHand(CardSet(cardsA), CardSet(commCards), numOtherPlayers, N, threadRng());
+}
 
-        bool aWins = true;
-        for(auto& v : otherPlayerCards) {
-            auto otherGuyFHR = calcFullHandRank(v);
-            auto showdownResult = showdownFHR(fhrA, otherGuyFHR);
-            if( showdownResult == otherGuyFHR ) aWins = false;
-        }
-        
-        if( aWins ) {
-            winCountA++;
-            outcomes[iN] = 1;
+std::tuple<double,double> monteCarloSingleHand(const CardSet& cardsA, const CardSet& commCards, const int numOtherPlayers, const uint64_t N, Rng& rng) {
+    // returns Avg win rate and standard deviation
+    const CardSet cardsUnion = cardsA | commCards;
+    const HandStrength strengthA = evaluateHand(cardsUnion);
+
+    const auto wins = runInChunks<uint64_t>(N, kHandsPerChunk, rng, [&](Rng& chunkRng, const uint64_t n) {
+        Deck newdeck;
+        uint64_t winCountA = 0;
+        for(uint64_t iN = 0; iN < n; iN++) {
+            // put back everything but the known cards
+            newdeck.reset(cardsUnion);
+            // deal other player's cards
+            bool aWins = true;
+            for(int p=0; p<numOtherPlayers; p++) {
+                const CardSet otherHand = commCards | newdeck.pop_cards(chunkRng, 2);
+                if( evaluateHand(otherHand) > strengthA ) aWins = false;
+            }
+            if( aWins ) winCountA++;
         }
-    }
+        return winCountA;
+    });
 
-    const double winRateA = double(winCountA)/N;
-    //std::cout << "A winrate: " << winRateA*100.0 << "%" << std::endl;
-    //std::cout << N << " hands calculated in " << duration.count() << " seconds, or " << double(N)/duration.count() << " hands/second" << std::endl;
-    double sigma = 0.0;
-    for(auto& e : outcomes)
-    {
-        sigma += (e - winRateA)*(e - winRateA);
-    }
-    sigma /= N;
-    sigma = sqrt(sigma);
+    const double winRateA = double(std::accumulate(wins.begin(), wins.end(), uint64_t(0)))/N;
+    const double sigma = sqrt(winRateA*(1.0 - winRateA));
     return std::make_tuple(winRateA, sigma);
 }
 
-  void monteCarloHandRankCompare(const std::vector<Card>& cardsA, const std::vector<Card>& cardsB, const uint64_t& N) {
-      std::random_device rd;
-
-      uint64_t winCountA = 0;
-      uint64_t winCountB = 0;
-
-      constexpr int numComCards = 5;
-      
-      std::vector<Card> cardsUnion (cardsA.begin(), cardsA.end());
-      cardsUnion.insert(cardsUnion.end(), cardsB.begin(), cardsB.end());
-
+  void monteCarloHandRankCompare(const std::vector<Card>& cardsA, const std::vector<Card>& cardsB, const double& tgt) {
+      // Samples boards until A's equity is known to within tgt (95% confidence)
+      PrecisionTarget target;
+      target.tolerance = tgt;
       auto start = std::chrono::steady_clock::now();
-      winCountA = 0;
-      winCountB = 0;
-      for(int iN = 0; iN < N; iN++) {
-        std::vector<Card> communityCards(numComCards);
-        std::vector<Card> cardsAMutable(cardsA);
-        std::vector<Card> cardsBMutable(cardsB);
-        //make new deck without players' cards
-        Deck newdeck(cardsUnion);
-        newdeck.shuffle();
-        for(short j=0; j<numComCards; j++)
-            communityCards[j]=newdeck.pop_card();
-        cardsAMutable.insert(cardsAMutable.end(), communityCards.begin(), communityCards.end());
-        cardsBMutable.insert(cardsBMutable.end(), communityCards.begin(), communityCards.end());
-
-        const FullHandRank fhrA = calcFullHandRank(cardsAMutable);
-        const FullHandRank fhrB = calcFullHandRank(cardsBMutable);
-        auto showdownResult = showdownFHR(fhrA, fhrB);
-        
-        if(showdownResult == fhrA) winCountA++;
-        else if(showdownResult == fhrB) winCountB++;
-      }
+      const std::vector<EquityResult> equity = equityVsHandsToPrecision({CardSet(cardsA), CardSet(cardsB)}, CardSet(), target);
+      std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
 
+      const uint64_t numHands = equity[0].samples;
+      std::cout << "A: " << equity[0] << std::endl;
+      std::cout << "B: " << equity[1] << std::endl;
+      std::cout << numHands << " hands calculated in " << duration.count() << " seconds, or " << double(numHands)/duration.count() << " hands/second" << std::endl;
+  }
 
+  void monteCarloHandRankCompare(const std::vector<Card>& cardsA, const std::vector<Card>& cardsB, const uint64_t& N) {
+      // Runs out the whole board; when there are no more than N boards every one of them is dealt once
+      auto start = std::chrono::steady_clock::now();
+      const std::vector<EquityResult> equity = equityVsHands({CardSet(cardsA), CardSet(cardsB)}, CardSet(), N);
       std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
-      const double winRateA = double(winCountA)/N;
-      const double winRateB = double(winCountB)/N;
-      const int64_t numDraws = N - winCountA - winCountB;
+
+      const uint64_t numHands = equity[0].samples;
+      const double winRateA = equity[0].win;
+      const double winRateB = equity[1].win;
+      const int64_t numDraws = std::llround(equity[0].tie * numHands);
       std::cout << "A winrate: " << winRateA*100.0 << "%" << std::endl;
       std::cout << "B winrate: " << winRateB*100.0 << "%" << std::endl;
       std::cout << "number of draws: " << numDraws << std::endl;
-      std::cout << N << " hands calculated in " << duration.count() << " seconds, or " << double(N)/duration.count() << " hands/second" << std::endl;
+      std::cout << numHands << " hands calculated in " << duration.count() << " seconds, or " << double(numHands)/duration.count() << " hands/second" << std::endl;
   }
 
 
@@ -352,33 +341,27 @@ std::tuple<double,double> monteCarloSingleHand(const std::vector<Card>& cardsA,
 void monteCarloRandomHand(const int numCommCards, const int numOtherPlayers, const uint64_t numHands, const uint64_t numHandMC, std::string outFileName, int numThreads) {
     // Generates a random hand and community cards
     // Records them to a file as well as the likelihood of winning with that hand
+    // The hands run on the shared pool in at most numThreads chunks
 
     std::ofstream outFile(outFileName, std::ios_base::app);
     if( !outFile ) throw;
 
-
-    auto doWork = [&]() {
-        std::random_device rd;
-        int prntCnt = 0;
+    const uint64_t maxChunks = std::max(numThreads, 1);
+    const uint64_t perChunk = std::max<uint64_t>(16, (numHands + maxChunks - 1) / maxChunks);
+    const auto lines = runInChunks<std::string>(numHands, perChunk, threadRng(), [&](Rng& rng, const uint64_t n) {
         std::string ret;
-        for(int iN=0; iN<numHands/numThreads; iN++) {
+        Deck newdeck;
+        for(uint64_t iN=0; iN<n; iN++) {
             std::ostringstream oss;
-            Deck newdeck;
-            newdeck.setSeed(rd());
-            newdeck.shuffle();
-            std::vector<Card> commCards(numCommCards);
-            std::vector<Card> myCards(2);
-
+            newdeck.reset();
             // deal community cards
-            for(short j=0; j<numCommCards; j++)
-                commCards[j]=newdeck.pop_card();
-            myCards[0]=newdeck.pop_card();
-            myCards[1]=newdeck.pop_card();
-
-            auto [avg, sigma] = monteCarloSingleHand( myCards, commCards, numOtherPlayers, numHandMC );
-            std::vector<Card> allCards = myCards;
-            allCards.insert(allCards.end(), commCards.begin(), commCards.end());
-            std::vector<std::tuple<int, int>> charlesFormatCards = convertMikeToCharles(allCards);
+            const CardSet commCards = newdeck.pop_cards(rng, numCommCards);
+            const CardSet myCards = newdeck.pop_cards(rng, 2);
+
+            auto [avg, sigma] = monteCarloSingleHand( myCards, commCards, numOtherPlayers, numHandMC, rng );
+            std::vector<std::tuple<int, int>> charlesFormatCards = convertCardSetToCharles(myCards);
+            for(auto& pair : convertCardSetToCharles(commCards))
+                charlesFormatCards.emplace_back(pair);
             oss << numOtherPlayers << ",";
             for(auto& pair : charlesFormatCards) {
                 oss << std::get<0>(pair) << "," << std::get<1>(pair) << ",";
@@ -386,31 +369,12 @@ void monteCarloRandomHand(const int numCommCards, const int numOtherPlayers, con
             oss << avg;
             oss << std::endl;
             ret.append(oss.str());
-            //if( ++prntCnt == 1000 ) {
-            //    prntCnt = 0;
-            //    std::cout << iN << "/" << numHands << std::endl;
-            //}
         }
         return ret;
-    };
-    /*
-    std::vector<std::future<std::string>> futures;
-    std::vector<std::string> results;
-    for(int j = 0; j < numThreads; j++)
-        futures.emplace_back(std::async(std::launch::async, doWork));
-    for( auto& fut : futures) 
-        results.push_back(fut.get());
-    for( auto& str : results)
+    });
+    for( auto& str : lines)
         outFile << str;
     outFile.close();
-    */
-
 }
-    
-
-
-
-
-
 
 }
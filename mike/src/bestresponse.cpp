@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "bestresponse.h"
+#include "evaluator.h"
+#include "holecards.h"
+#include "mccfr.h"
+#include "regret.h"
+#include "showdown.h"
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    constexpr int kNumHands = HoleCards::kNumHands;
+    constexpr int kNumActions = HeadsUpState::kNumActions;
+    constexpr int kNumClasses = CFRAI1::kNumHandClasses;
+
+    const HoleCards& kHands = HoleCards::all();
+
+    double pairsLeft(const int boardSize) {
+        // Opponent hands that fit with one hand and the board
+        const double n = 50 - boardSize;
+        return n * (n - 1) / 2;
+    }
+  }
+
+  struct BestResponse::BoardNode {
+      int street = 0;
+      CardSet board;
+      std::vector<uint8_t> handClass;                         // CFRAI1::handClassOf every hand on this board
+      std::vector<HandStrength> strength;                     // river only
+      std::vector<uint16_t> byStrength;                       // river only: hands that fit the board, weakest first
+      std::vector<BoardNode> children;
+
+      void build(const int street_in, const CardSet& board_in, const HandBuckets* buckets) {
+          street = street_in;
+          board = board_in;
+          handClass.assign(kNumHands, 0);
+          for(int h = 0; h < kNumHands; h++)
+              if( !kHands.set[h].intersects(board) ) handClass[h] = CFRAI1::handClassOf(kHands.set[h], board, buckets);
+          if( street != 3 ) return;
+          strength.assign(kNumHands, 0);
+          byStrength.resize(kNumHands);
+          byStrength.resize(rankRiverHands(board, strength.data(), byStrength.data()));
+      }
+  };
+
+  class BestResponse::Walk {
+      // One best-response computation: responder br against policy in the other seat
+      public:
+          Walk(const HeadsUpSettings& settings, const Policy& policy, const int br)
+              : settings(settings), policy(policy), br(br) {}
+
+          void operator()(const HeadsUpState& s, const BoardNode& node, const std::vector<float>& oppReach, std::vector<double>& value) const {
+              value.assign(kNumHands, 0.0);
+              if( s.folded[0] or s.folded[1] ) return fold(s, node, oppReach, value);
+              if( node.street < std::min(s.street, 3) ) return chance(s, node, oppReach, value);
+              if( s.terminal() ) return showdown(s, node, oppReach, value);
+
+              bool legal[kNumActions];
+              s.legalActions(settings, legal);
+              std::vector<double> child;
+              if( s.toAct == br ) {
+                  // The responder picks its best action separately for every hand
+                  bool first = true;
+                  for(int a = 0; a < kNumActions; a++) {
+                      if( !legal[a] ) continue;
+                      (*this)(s.apply(settings, a), node, oppReach, child);
+                      for(int h = 0; h < kNumHands; h++)
+                          value[h] = first ? child[h] : std::max(value[h], child[h]);
+                      first = false;
+                  }
+                  return;
+              }
+
+              // The policy plays each of its hands by the strategy of that hand's class
+              float sigma[kNumClasses][kNumActions];
+              bool known[kNumClasses] = {};
+              for(int h = 0; h < kNumHands; h++) {
+                  const int c = node.handClass[h];
+                  if( known[c] or oppReach[h] == 0.0f ) continue;
+                  strategy(s, c, legal, sigma[c]);
+                  known[c] = true;
+              }
+              std::vector<float> reach(kNumHands);
+              for(int a = 0; a < kNumActions; a++) {
+                  if( !legal[a] ) continue;
+                  bool reached = false;
+                  for(int h = 0; h < kNumHands; h++) {
+                      reach[h] = oppReach[h] == 0.0f ? 0.0f : oppReach[h] * sigma[node.handClass[h]][a];
+                      reached = reached or reach[h] > 0.0f;
+                  }
+                  if( !reached ) continue;
+                  (*this)(s.apply(settings, a), node, reach, child);
+                  for(int h = 0; h < kNumHands; h++) value[h] += child[h];
+              }
+          }
+
+      private:
+          const HeadsUpSettings& settings;
+          const Policy& policy;
+          const int br;
+
+          void strategy(const HeadsUpState& s, const int handClass, const bool legal[], float sigma[]) const {
+              const auto w = policy(s.key(1 - br, handClass));
+              RegretRule::regretMatching(w.data(), legal, kNumActions, sigma);
+          }
+
+          void chance(const HeadsUpState& s, const BoardNode& node, const std::vector<float>& oppReach, std::vector<double>& value) const {
+              // Averages over the sampled cards that fit each hand; flops are walked in parallel
+              const size_t n = node.children.size();
+              std::vector<std::vector<double>> childValue(n);
+              auto walkChild = [&](const size_t k) {
+                  const CardSet dealt = node.children[k].board;
+                  std::vector<float> reach(oppReach);
+                  for(int h = 0; h < kNumHands; h++)
+                      if( kHands.set[h].intersects(dealt) ) reach[h] = 0.0f;
+                  (*this)(s, node.children[k], reach, childValue[k]);
+              };
+              if( node.street == 0 ) ThreadPool::instance().parallelFor(n, walkChild);
+              else for(size_t k = 0; k < n; k++) walkChild(k);
+
+              for(int h = 0; h < kNumHands; h++) {
+                  int fits = 0;
+                  for(size_t k = 0; k < n; k++) {
+                      if( kHands.set[h].intersects(node.children[k].board) ) continue;
+                      value[h] += childValue[k][h];
+                      fits++;
+                  }
+                  if( fits ) value[h] /= fits;
+              }
+          }
+
+          void fold(const HeadsUpState& s, const BoardNode& node, const std::vector<float>& oppReach, std::vector<double>& value) const {
+              // The payoff doesn't depend on the cards, only on how much of the policy's range fits each hand
+              const double payoff = s.folded[br] ? -s.committed[br] : s.committed[1 - br];
+              double total = 0.0;
+              double withCard[kCardIndexLimit] = {};
+              for(int h = 0; h < kNumHands; h++) {
+                  total += oppReach[h];
+                  withCard[kHands.card[h][0]] += oppReach[h];
+                  withCard[kHands.card[h][1]] += oppReach[h];
+              }
+              const double norm = payoff / pairsLeft(node.board.size());
+              for(int h = 0; h < kNumHands; h++) {
+                  if( kHands.set[h].intersects(node.board) ) continue;
+                  value[h] = norm * (total - withCard[kHands.card[h][0]] - withCard[kHands.card[h][1]] + oppReach[h]);
+              }
+          }
+
+          void showdown(const HeadsUpState& s, const BoardNode& node, const std::vector<float>& oppReach, std::vector<double>& value) const {
+              // Each hand wins against the policy's weaker mass and loses against its stronger mass
+              const double win = s.committed[1 - br] / pairsLeft(5);
+              const double lose = s.committed[br] / pairsLeft(5);
+              sweepByStrength(node.byStrength.data(), node.byStrength.size(), node.strength.data(),
+                              [&oppReach](const int h) { return double(oppReach[h]); },
+                              [&value, win, lose](const int pass, const int h, const double other) { value[h] += pass == 0 ? win * other : -lose * other; });
+          }
+  };
+
+  BestResponse::BestResponse(const Settings& settings_in) : settings(settings_in), root(std::make_unique<BoardNode>()) {
+      if( settings.flops <= 0 or settings.turnsPerFlop <= 0 or settings.riversPerTurn <= 0 )
+          throw std::invalid_argument("BestResponse: need at least one flop, turn and river");
+
+      // Sample the boards serially so they depend only on the seed, then evaluate them on the pool
+      Rng rng(settings.seed);
+      Deck deck;
+      root->build(0, CardSet(), settings.buckets.get());
+      root->children.resize(settings.flops);
+      std::vector<BoardNode*> pending;
+      for(BoardNode& flop : root->children) {
+          deck.reset();
+          flop.board = deck.pop_cards(rng, 3);
+          flop.children.resize(settings.turnsPerFlop);
+          for(BoardNode& turn : flop.children) {
+              deck.reset(flop.board);
+              turn.board = flop.board | deck.pop_cards(rng, 1);
+              turn.children.resize(settings.riversPerTurn);
+              for(BoardNode& river : turn.children) {
+                  deck.reset(turn.board);
+                  river.board = turn.board | deck.pop_cards(rng, 1);
+                  pending.push_back(&river);
+              }
+              pending.push_back(&turn);
+          }
+          pending.push_back(&flop);
+      }
+      ThreadPool::instance().parallelFor(pending.size(), [this, &pending](const size_t i) {
+          BoardNode* node = pending[i];
+          node->build(node->board.size() == 3 ? 1 : node->board.size() == 4 ? 2 : 3, node->board, settings.buckets.get());
+      });
+  }
+
+  BestResponse::~BestResponse() = default;
+
+  double BestResponse::value(const Policy& policy, const int seat) const {
+      const Walk walk(settings, policy, seat);
+      std::vector<float> reach(kNumHands, 1.0f);
+      std::vector<double> value;
+      walk(HeadsUpState::start(settings), *root, reach, value);
+      // A hand that collides with every sampled flop has no value for the lines that reach the flop, so the
+      // average is over the hands that fit at least one
+      double total = 0.0;
+      int counted = 0;
+      for(int h = 0; h < kNumHands; h++) {
+          const bool seesFlop = std::any_of(root->children.begin(), root->children.end(),
+                                            [h](const BoardNode& flop) { return !kHands.set[h].intersects(flop.board); });
+          if( !seesFlop ) continue;
+          total += value[h];
+          counted++;
+      }
+      return total / counted;
+  }
+
+  Exploitability BestResponse::exploitability(const Policy& policy) const {
+      Exploitability e;
+      for(int seat = 0; seat < 2; seat++) e.bestResponse[seat] = value(policy, seat);
+      e.chipsPerHand = (e.bestResponse[0] + e.bestResponse[1]) / 2.0;
+      e.mbbPerHand = 1000.0 * e.chipsPerHand / settings.bigBlind;
+      return e;
+  }
+
+  BestResponse::Policy BestResponse::policyOf(const CFRAI1& ai) {
+      return [&ai](const CFRAI1::InfosetKey key) {
+          std::array<float, CFRAI1::kNumBinnedMoves> w;
+          if( ai.policyFile ) {
+              if( const StrategyFile::Entry* e = ai.policyFile->find(key) ) {
+                  std::copy(e->values, e->values + w.size(), w.begin());
+                  return w;
+              }
+          }
+          if( const auto slot = ai.CFRTable.find(key) ) {
+              for(size_t a = 0; a < w.size(); a++) w[a] = slot->values[a].load(std::memory_order_relaxed);
+              return w;
+          }
+          w.fill(1.0f);
+          return w;
+      };
+  }
+
+  BestResponse::Policy BestResponse::policyOf(const MCCFRTrainer& trainer) {
+      return [&trainer](const CFRAI1::InfosetKey key) { return trainer.averageStrategy(key); };
+  }
+
+}
@@ -0,0 +1,406 @@
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+#include "equity.h"
+#include "evaluator.h"
+#include "stats.h"
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    constexpr int kBoardSize = 5;
+    constexpr uint64_t kDealsPerChunk = 2048;
+    constexpr double kMinParallelDeals = 20000;     // smaller enumerations aren't worth handing to the pool
+    constexpr double kZ95 = 1.96;                   // normal quantile of a two-sided 95% interval
+    constexpr uint64_t kFirstBatch = 256;           // adaptive sampling checks its precision after every batch,
+    constexpr uint64_t kMaxBatch = 1 << 16;         // doubling the batch up to this size
+
+    struct Tally {
+        uint64_t win = 0;
+        uint64_t tie = 0;
+        uint64_t loss = 0;
+        RunningStats share;         // pot share of every deal, for the mean and its standard error
+
+        void add(const HandStrength mine, const HandStrength best, const int numBest) {
+            // numBest counts every hand holding the best strength, including this one if it does
+            if( mine < best ) { loss++; share.add(0.0); }
+            else if( numBest == 1 ) { win++; share.add(1.0); }
+            else { tie++; share.add(1.0 / numBest); }
+        }
+        Tally& operator+=(const Tally& o) {
+            win += o.win;
+            tie += o.tie;
+            loss += o.loss;
+            share += o.share;
+            return *this;
+        }
+        EquityResult result(const bool exact) const {
+            EquityResult r;
+            r.samples = win + tie + loss;
+            r.exact = exact;
+            if( r.samples == 0 ) return r;
+            r.win = double(win) / r.samples;
+            r.tie = double(tie) / r.samples;
+            r.loss = double(loss) / r.samples;
+            r.share = share.mean();
+            r.standardError = exact ? 0.0 : share.standardError();
+            return r;
+        }
+    };
+
+    double choose(const int n, const int k) {
+        if( k < 0 or k > n ) return 0.0;
+        double c = 1.0;
+        for(int i = 1; i <= k; i++)
+            c = c * (n - k + i) / i;
+        return c;
+    }
+
+    // The cards left in the deck, as single-card masks in index order
+    struct LiveCards {
+        uint64_t card[52];
+        int n = 0;
+        explicit LiveCards(const CardSet& known) {
+            known.complement().forEachIndex([this](int i) { card[n++] = 1ULL << i; });
+        }
+    };
+
+    struct RandomOpponentsEnumerator {
+        // Walks every board runout and, for each, every set of opponent hands exactly once.
+        // Opponents are interchangeable, so their hands are dealt in increasing order of lowest card.
+        // The outermost choice (first runout card, or the first opponent's first card on the river)
+        // is left to the caller so it can be split across threads
+        const CardSet hole;
+        const CardSet board;
+        const int boardLeft;
+        const int numOpponents;
+        const LiveCards live;
+
+        RandomOpponentsEnumerator(const CardSet& hole_in, const CardSet& board_in, const int numOpponents_in) :
+            hole(hole_in), board(board_in), boardLeft(kBoardSize - static_cast<int>(board_in.size())),
+            numOpponents(numOpponents_in), live(hole_in | board_in) {};
+
+        int numTopChoices() const {
+            if( boardLeft > 0 ) return live.n - boardLeft + 1;
+            if( numOpponents > 0 ) return live.n - 1;
+            return 1;
+        }
+
+        void runTopChoice(const int i, Tally& t) const {
+            if( boardLeft > 0 ) dealBoard(i + 1, boardLeft - 1, board.mask | live.card[i], t);
+            else if( numOpponents > 0 ) showdown(board.mask, i, i + 1, t);
+            else showdown(board.mask, 0, live.n, t);
+        }
+
+        void dealBoard(const int start, const int left, const uint64_t runout, Tally& t) const {
+            if( left == 0 ) {
+                showdown(runout, 0, live.n, t);
+                return;
+            }
+            for(int i = start; i <= live.n - left; i++)
+                dealBoard(i + 1, left - 1, runout | live.card[i], t);
+        }
+
+        void showdown(const uint64_t runout, const int firstBegin, const int firstEnd, Tally& t) const {
+            const HandStrength mine = evaluateHand(CardSet(hole.mask | runout));
+            dealOpponents(runout, runout, firstBegin, firstEnd, numOpponents, mine, mine, 1, t);
+        }
+
+        void dealOpponents(const uint64_t runout, const uint64_t used, const int firstBegin, const int firstEnd,
+                           const int left, const HandStrength mine, const HandStrength best, const int numBest, Tally& t) const {
+            if( left == 0 ) {
+                t.add(mine, best, numBest);
+                return;
+            }
+            for(int a = firstBegin; a < firstEnd; a++) {
+                if( used & live.card[a] ) continue;
+                for(int b = a + 1; b < live.n; b++) {
+                    if( used & live.card[b] ) continue;
+                    const uint64_t hand = live.card[a] | live.card[b];
+                    const HandStrength s = evaluateHand(CardSet(runout | hand));
+                    if( s > best )       dealOpponents(runout, used | hand, a + 1, live.n, left - 1, mine, s, 1, t);
+                    else if( s == best ) dealOpponents(runout, used | hand, a + 1, live.n, left - 1, mine, best, numBest + 1, t);
+                    else                 dealOpponents(runout, used | hand, a + 1, live.n, left - 1, mine, best, numBest, t);
+                }
+            }
+        }
+    };
+
+    template<typename Enumerator, typename Result>
+    void enumerateOnPool(const Enumerator& e, const double numDeals, Result& total) {
+        // Every top-level choice gets its own tally, summed in order so the result doesn't depend on scheduling
+        const int nTop = e.numTopChoices();
+        if( numDeals < kMinParallelDeals or nTop == 1 ) {
+            for(int i = 0; i < nTop; i++) e.runTopChoice(i, total);
+            return;
+        }
+        std::vector<Result> tallies(nTop, total);
+        ThreadPool::instance().parallelFor(nTop, [&](const size_t i) { e.runTopChoice(i, tallies[i]); });
+        for(const Result& t : tallies) total += t;
+    }
+
+    struct KnownHandsEnumerator {
+        // Walks every board runout for a fixed set of hands
+        const std::vector<CardSet>& hands;
+        const CardSet board;
+        const int boardLeft;
+        const LiveCards live;
+
+        struct Tallies {
+            std::vector<Tally> perHand;
+            Tallies& operator+=(const Tallies& o) {
+                for(size_t h = 0; h < perHand.size(); h++) perHand[h] += o.perHand[h];
+                return *this;
+            }
+        };
+
+        KnownHandsEnumerator(const std::vector<CardSet>& hands_in, const CardSet& board_in, const CardSet& known) :
+            hands(hands_in), board(board_in), boardLeft(kBoardSize - static_cast<int>(board_in.size())), live(known) {};
+
+        int numTopChoices() const { return boardLeft > 0 ? live.n - boardLeft + 1 : 1; }
+
+        void runTopChoice(const int i, Tallies& t) const {
+            if( boardLeft > 0 ) dealBoard(i + 1, boardLeft - 1, board.mask | live.card[i], t);
+            else showdown(board.mask, t);
+        }
+
+        void dealBoard(const int start, const int left, const uint64_t runout, Tallies& t) const {
+            if( left == 0 ) {
+                showdown(runout, t);
+                return;
+            }
+            for(int i = start; i <= live.n - left; i++)
+                dealBoard(i + 1, left - 1, runout | live.card[i], t);
+        }
+
+        void showdown(const uint64_t runout, Tallies& t) const {
+            scoreShowdown(hands, runout, t.perHand);
+        }
+
+        static void scoreShowdown(const std::vector<CardSet>& hands, const uint64_t runout, std::vector<Tally>& perHand) {
+            HandStrength strengths[kCardIndexLimit];
+            HandStrength best = 0;
+            int numBest = 0;
+            for(size_t h = 0; h < hands.size(); h++) {
+                strengths[h] = evaluateHand(CardSet(hands[h].mask | runout));
+                if( strengths[h] > best ) { best = strengths[h]; numBest = 1; }
+                else if( strengths[h] == best ) numBest++;
+            }
+            for(size_t h = 0; h < hands.size(); h++)
+                perHand[h].add(strengths[h], best, numBest);
+        }
+    };
+
+    void checkDeal(const CardSet& known, const size_t numKnownCards, const CardSet& board, const int numOpponents) {
+        if( known.size() != numKnownCards )
+            throw std::invalid_argument("equity: the same card appears twice");
+        if( board.size() > kBoardSize )
+            throw std::invalid_argument("equity: more than five board cards");
+        if( numOpponents < 0 or known.size() + (kBoardSize - board.size()) + 2 * numOpponents > 52 )
+            throw std::invalid_argument("equity: not enough cards left to deal");
+    }
+
+    struct RandomOpponentsSampler {
+        const CardSet hole;
+        const CardSet board;
+        const int numOpponents;
+        const CardSet known;
+        const int boardLeft;
+
+        RandomOpponentsSampler(const CardSet& hole_in, const CardSet& board_in, const int numOpponents_in) :
+            hole(hole_in), board(board_in), numOpponents(numOpponents_in), known(hole_in | board_in),
+            boardLeft(kBoardSize - static_cast<int>(board_in.size())) {
+            checkDeal(known, hole.size() + board.size(), board, numOpponents);
+        }
+
+        double numDeals() const { return numPossibleDeals(known.size(), boardLeft, numOpponents); }
+
+        Tally operator()(Rng& rng, const uint64_t n) const {
+            Deck deck;
+            Tally t;
+            for(uint64_t iN = 0; iN < n; iN++) {
+                deck.reset(known);
+                const CardSet runout = board | deck.pop_cards(rng, boardLeft);
+                const HandStrength mine = evaluateHand(hole | runout);
+                HandStrength best = mine;
+                int numBest = 1;
+                for(int p = 0; p < numOpponents; p++) {
+                    const HandStrength s = evaluateHand(runout | deck.pop_cards(rng, 2));
+                    if( s > best ) { best = s; numBest = 1; }
+                    else if( s == best ) numBest++;
+                }
+                t.add(mine, best, numBest);
+            }
+            return t;
+        }
+
+        Tally enumerate() const {
+            Tally total;
+            enumerateOnPool(RandomOpponentsEnumerator(hole, board, numOpponents), numDeals(), total);
+            return total;
+        }
+    };
+
+    using Tallies = KnownHandsEnumerator::Tallies;
+
+    struct KnownHandsSampler {
+        const std::vector<CardSet>& hands;
+        const CardSet board;
+        const int boardLeft;
+        CardSet known;
+
+        KnownHandsSampler(const std::vector<CardSet>& hands_in, const CardSet& board_in) :
+            hands(hands_in), board(board_in), boardLeft(kBoardSize - static_cast<int>(board_in.size())), known(board_in) {
+            size_t numKnownCards = board.size();
+            for(const CardSet& h : hands) {
+                known |= h;
+                numKnownCards += h.size();
+            }
+            checkDeal(known, numKnownCards, board, 0);
+            if( hands.size() > kCardIndexLimit )
+                throw std::invalid_argument("equity: too many hands");
+        }
+
+        double numDeals() const { return numPossibleDeals(known.size(), boardLeft, 0); }
+        Tallies empty() const { return Tallies { std::vector<Tally>(hands.size()) }; }
+
+        Tallies operator()(Rng& rng, const uint64_t n) const {
+            Deck deck;
+            Tallies t = empty();
+            for(uint64_t iN = 0; iN < n; iN++) {
+                deck.reset(known);
+                const CardSet runout = board | deck.pop_cards(rng, boardLeft);
+                KnownHandsEnumerator::scoreShowdown(hands, runout.mask, t.perHand);
+            }
+            return t;
+        }
+
+        Tallies enumerate() const {
+            Tallies total = empty();
+            enumerateOnPool(KnownHandsEnumerator(hands, board, known), numDeals(), total);
+            return total;
+        }
+    };
+
+    std::vector<EquityResult> toResults(const Tallies& total, const bool exact) {
+        std::vector<EquityResult> results;
+        results.reserve(total.perHand.size());
+        for(const Tally& t : total.perHand)
+            results.emplace_back(t.result(exact));
+        return results;
+    }
+
+    bool isPrecise(const RunningStats& s, const PrecisionTarget& target) {
+        // Precise once the 95% interval is narrow enough, or once it has left every decision threshold behind.
+        // A share lies in [0, 1], so its variance is at most p(1 - p); the variance used is never below that bound
+        // at the Agresti-Coull estimate of p (two wins and two losses added), so runs that happen to have no variance
+        // yet, like a hand that has lost every deal so far, still need enough deals to rule out a rare win
+        if( s.count() == 0 ) return false;
+        const double n = double(s.count());
+        const double p = (s.mean() * n + 2.0) / (n + 4.0);
+        const double halfWidth = kZ95 * std::sqrt(std::max(s.variance(), p * (1.0 - p)) / n);
+        if( halfWidth <= target.tolerance ) return true;
+        if( target.thresholds.empty() ) return false;
+        for(const double threshold : target.thresholds)
+            if( std::fabs(s.mean() - threshold) <= halfWidth ) return false;
+        return true;
+    }
+
+    uint64_t worstCaseSamples(const PrecisionTarget& target) {
+        // Samples needed at the largest possible variance of a pot share (1/4)
+        const double n = std::ceil(std::pow(kZ95 * 0.5 / target.tolerance, 2));
+        return n < double(target.maxSamples) ? static_cast<uint64_t>(n) : target.maxSamples;
+    }
+
+    template<typename Result, typename Sampler, typename Done>
+    void sampleUntil(const PrecisionTarget& target, Rng& rng, const Sampler& sample, Done&& done, Result& total) {
+        // Batches double in size so the precision checks cost nothing, and large batches spread over the pool
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t samples = 0;
+        uint64_t batch = kFirstBatch;
+        while( samples < target.maxSamples ) {
+            batch = std::min(batch, target.maxSamples - samples);
+            for(const Result& r : runInChunks<Result>(batch, kDealsPerChunk, rng, sample))
+                total += r;
+            samples += batch;
+            if( done(total) ) break;
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if( target.maxSeconds > 0.0 and elapsed.count() >= target.maxSeconds ) break;
+            batch = std::min(batch * 2, kMaxBatch);
+        }
+    }
+  }
+
+  std::ostream& operator<<(std::ostream& os, const EquityResult& r) {
+      const std::ios_base::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      os << std::fixed << std::setprecision(2)
+         << "win " << r.win * 100.0 << "% tie " << r.tie * 100.0 << "% loss " << r.loss * 100.0
+         << "% equity " << r.share * 100.0;
+      if( r.exact ) os << "% (" << r.samples << " deals, exact)";
+      else os << " +- " << kZ95 * r.standardError * 100.0 << "% (" << r.samples << " samples)";
+      os.flags(flags);
+      os.precision(precision);
+      return os;
+  }
+
+  double numPossibleDeals(const int numKnown, const int boardCardsLeft, const int numOpponents) {
+      // Runouts times the ways to split the remaining cards into numOpponents unordered pairs
+      const int n = 52 - numKnown;
+      double deals = choose(n, boardCardsLeft);
+      double pairs = 1.0;
+      for(int i = 0; i < numOpponents; i++)
+          pairs *= choose(n - boardCardsLeft - 2 * i, 2) / (i + 1);
+      return deals * pairs;
+  }
+
+  EquityResult equityVsRandom(const CardSet& hole, const CardSet& board, const int numOpponents, const uint64_t N, Rng& rng) {
+      const RandomOpponentsSampler sampler(hole, board, numOpponents);
+      if( sampler.numDeals() <= double(N) )
+          return sampler.enumerate().result(true);
+
+      Tally total;
+      for(const Tally& t : runInChunks<Tally>(N, kDealsPerChunk, rng, sampler))
+          total += t;
+      return total.result(false);
+  }
+
+  std::vector<EquityResult> equityVsHands(const std::vector<CardSet>& hands, const CardSet& board, const uint64_t N, Rng& rng) {
+      const KnownHandsSampler sampler(hands, board);
+      if( sampler.numDeals() <= double(N) )
+          return toResults(sampler.enumerate(), true);
+
+      Tallies total = sampler.empty();
+      for(const Tallies& t : runInChunks<Tallies>(N, kDealsPerChunk, rng, sampler))
+          total += t;
+      return toResults(total, false);
+  }
+
+  EquityResult equityToPrecision(const CardSet& hole, const CardSet& board, const int numOpponents, const PrecisionTarget& target, Rng& rng) {
+      const RandomOpponentsSampler sampler(hole, board, numOpponents);
+      if( sampler.numDeals() <= double(worstCaseSamples(target)) )
+          return sampler.enumerate().result(true);
+
+      Tally total;
+      sampleUntil(target, rng, sampler, [&target](const Tally& t) { return isPrecise(t.share, target); }, total);
+      return total.result(false);
+  }
+
+  std::vector<EquityResult> equityVsHandsToPrecision(const std::vector<CardSet>& hands, const CardSet& board, const PrecisionTarget& target, Rng& rng) {
+      const KnownHandsSampler sampler(hands, board);
+      if( sampler.numDeals() <= double(worstCaseSamples(target)) )
+          return toResults(sampler.enumerate(), true);
+
+      Tallies total = sampler.empty();
+      sampleUntil(target, rng, sampler, [&target](const Tallies& t) {
+          for(const Tally& h : t.perHand)
+              if( !isPrecise(h.share, target) ) return false;
+          return true;
+      }, total);
+      return toResults(total, false);
+  }
+
+}
@@ -0,0 +1,213 @@
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include "evaluator.h"
+
+namespace Poker {
+  namespace {
+    constexpr int kNumRanks = 13;
+    constexpr int kMaxCards = 7;
+    constexpr int kMaxPerRank = 4;
+    constexpr uint64_t kRankLane = 0x0001000100010001ULL;     // one bit per suit for a given rank
+
+    constexpr uint32_t numRankHashes() {
+        // Number of rank multisets of 0..7 cards with at most 4 of each rank
+        uint32_t N[kNumRanks + 1][kMaxCards + 1] = {};
+        N[0][0] = 1;
+        for(int m = 1; m <= kNumRanks; m++)
+            for(int k = 0; k <= kMaxCards; k++)
+                for(int c = 0; c <= kMaxPerRank && c <= k; c++)
+                    N[m][k] += N[m - 1][k - c];
+        uint32_t total = 0;
+        for(int k = 0; k <= kMaxCards; k++)
+            total += N[kNumRanks][k];
+        return total;
+    }
+
+    // Hand keys use the FullHandRank::value layout, so they are ordered like hands
+    uint32_t makeKey(const HandRank category, std::initializer_list<int> ranks) {
+        uint32_t key = static_cast<uint32_t>(category) << 20;
+        int shift = 16;
+        for(const int r : ranks) {
+            if( r < 0 ) continue;
+            key |= static_cast<uint32_t>(r + 1) << shift;
+            shift -= 4;
+        }
+        return key;
+    }
+
+    int straightTop(const uint32_t rankMask) {
+        // Highest rank of a straight in the mask, or -1. The wheel (A2345) is a 5-high straight
+        for(int top = kNumRanks - 1; top >= 4; top--)
+            if( ((rankMask >> (top - 4)) & 0x1f) == 0x1f ) return top;
+        if( (rankMask & 0x100f) == 0x100f ) return static_cast<int>(Rank::C_5);
+        return -1;
+    }
+
+    int nextRank(const int counts[], const int minCount, int from, const int skipA = -1, const int skipB = -1) {
+        // Highest rank at or below 'from' with at least minCount cards
+        for(int r = from; r >= 0; r--)
+            if( counts[r] >= minCount and r != skipA and r != skipB ) return r;
+        return -1;
+    }
+
+    uint32_t flushKey(const uint32_t suitMask) {
+        const int top = straightTop(suitMask);
+        if( top >= 0 ) return makeKey(HandRank::STRAIGHT_FLUSH, {top});
+        int r[5];
+        int found = 0;
+        for(int i = kNumRanks - 1; i >= 0 and found < 5; i--)
+            if( suitMask & (1u << i) ) r[found++] = i;
+        return makeKey(HandRank::FLUSH, {r[0], r[1], r[2], r[3], r[4]});
+    }
+
+    uint32_t rankCountKey(const int counts[], const int numCards) {
+        // Best hand that can be made from the rank counts, ignoring flushes
+        if( numCards == 0 ) return 0;
+        constexpr int top = kNumRanks - 1;
+        uint32_t rankMask = 0;
+        for(int r = 0; r < kNumRanks; r++)
+            if( counts[r] ) rankMask |= 1u << r;
+
+        const int quad = nextRank(counts, 4, top);
+        if( quad >= 0 )
+            return makeKey(HandRank::FOUR_KIND, {quad, nextRank(counts, 1, top, quad)});
+
+        const int trip = nextRank(counts, 3, top);
+        const int pairForBoat = nextRank(counts, 2, top, trip);
+        if( trip >= 0 and pairForBoat >= 0 )
+            return makeKey(HandRank::FULL_HOUSE, {trip, pairForBoat});
+
+        const int straight = straightTop(rankMask);
+        if( straight >= 0 )
+            return makeKey(HandRank::STRAIGHT, {straight});
+
+        if( trip >= 0 ) {
+            const int k1 = nextRank(counts, 1, top, trip);
+            const int k2 = nextRank(counts, 1, k1 - 1, trip);
+            return makeKey(HandRank::THREE_KIND, {trip, k1, k1 < 0 ? -1 : k2});
+        }
+
+        const int pair1 = nextRank(counts, 2, top);
+        const int pair2 = pair1 < 0 ? -1 : nextRank(counts, 2, pair1 - 1);
+        if( pair2 >= 0 )
+            return makeKey(HandRank::TWO_PAIR, {pair1, pair2, nextRank(counts, 1, top, pair1, pair2)});
+
+        int k[5] = {-1, -1, -1, -1, -1};
+        int found = 0;
+        for(int r = top; r >= 0 and found < 5; r--)
+            if( counts[r] and r != pair1 ) k[found++] = r;
+        if( pair1 >= 0 )
+            return makeKey(HandRank::ONE_PAIR, {pair1, k[0], k[1], k[2]});
+        return makeKey(HandRank::HIGH_CARD, {k[0], k[1], k[2], k[3], k[4]});
+    }
+
+    struct EvaluatorTables {
+        uint32_t base[kMaxCards + 1];                                   // first hash of the hands with n cards
+        uint32_t offsets[kNumRanks][kMaxCards + 1][kMaxPerRank + 1];    // [rank][cards left][count of rank]
+        HandStrength rankHash[numRankHashes()];
+        HandStrength flush[1 << kNumRanks];
+        std::vector<uint32_t> strengthToKey;                            // strength-1 -> hand key
+
+        EvaluatorTables() {
+            // N[m][k] = number of ways to spread k cards over the m highest ranks
+            uint32_t N[kNumRanks + 1][kMaxCards + 1] = {};
+            N[0][0] = 1;
+            for(int m = 1; m <= kNumRanks; m++)
+                for(int k = 0; k <= kMaxCards; k++)
+                    for(int c = 0; c <= kMaxPerRank && c <= k; c++)
+                        N[m][k] += N[m - 1][k - c];
+            base[0] = 0;
+            for(int n = 1; n <= kMaxCards; n++)
+                base[n] = base[n - 1] + N[kNumRanks][n - 1];
+            for(int r = 0; r < kNumRanks; r++)
+                for(int rem = 0; rem <= kMaxCards; rem++) {
+                    uint32_t acc = 0;
+                    for(int c = 0; c <= kMaxPerRank; c++) {
+                        offsets[r][rem][c] = acc;
+                        if( c <= rem ) acc += N[kNumRanks - 1 - r][rem - c];
+                    }
+                }
+
+            // Enumerate every rank multiset and every flush mask, then number the distinct keys in order
+            std::vector<uint32_t> rankKeys(numRankHashes());
+            int counts[kNumRanks] = {};
+            enumerateCounts(counts, 0, 0, rankKeys);
+
+            std::vector<uint32_t> flushKeys(1 << kNumRanks, 0);
+            for(uint32_t m = 0; m < flushKeys.size(); m++) {
+                const int bits = __builtin_popcount(m);
+                if( bits >= 5 and bits <= kMaxCards ) flushKeys[m] = flushKey(m);
+            }
+
+            strengthToKey = rankKeys;
+            for(uint32_t m = 0; m < flushKeys.size(); m++)
+                if( flushKeys[m] ) strengthToKey.push_back(flushKeys[m]);
+            std::sort(strengthToKey.begin(), strengthToKey.end());
+            strengthToKey.erase(std::unique(strengthToKey.begin(), strengthToKey.end()), strengthToKey.end());
+
+            auto strengthOf = [this](const uint32_t key) -> HandStrength {
+                auto it = std::lower_bound(strengthToKey.begin(), strengthToKey.end(), key);
+                return static_cast<HandStrength>(std::distance(strengthToKey.begin(), it) + 1);
+            };
+            for(size_t h = 0; h < rankKeys.size(); h++)
+                rankHash[h] = strengthOf(rankKeys[h]);
+            for(uint32_t m = 0; m < flushKeys.size(); m++)
+                flush[m] = flushKeys[m] ? strengthOf(flushKeys[m]) : 0;
+        }
+
+        void enumerateCounts(int counts[], const int rank, const int total, std::vector<uint32_t>& keys) {
+            if( rank == kNumRanks ) {
+                keys[hash(counts, total)] = rankCountKey(counts, total);
+                return;
+            }
+            for(int c = 0; c <= kMaxPerRank and total + c <= kMaxCards; c++) {
+                counts[rank] = c;
+                enumerateCounts(counts, rank + 1, total + c, keys);
+            }
+            counts[rank] = 0;
+        }
+
+        uint32_t hash(const int counts[], int rem) const {
+            uint32_t h = base[rem];
+            for(int r = 0; r < kNumRanks and rem > 0; r++) {
+                h += offsets[r][rem][counts[r]];
+                rem -= counts[r];
+            }
+            return h;
+        }
+    };
+
+    const EvaluatorTables& tables() {
+        static const EvaluatorTables t;
+        return t;
+    }
+  }
+
+  HandStrength evaluateHand(const CardSet& cards) {
+      const EvaluatorTables& t = tables();
+      const uint64_t m = cards.mask;
+      int rem = __builtin_popcountll(m);
+      if( rem > kMaxCards ) return 0;
+      if( rem >= 5 ) {
+          for(int s = 0; s < 4; s++) {
+              const uint32_t suitMask = cards.suitMask(s);
+              if( __builtin_popcount(suitMask) >= 5 ) return t.flush[suitMask];
+          }
+      }
+      uint32_t h = t.base[rem];
+      for(int r = 0; r < kNumRanks and rem > 0; r++) {
+          // number of suits holding rank r
+          const int c = static_cast<int>((((m >> r) & kRankLane) * kRankLane) >> 48);
+          h += t.offsets[r][rem][c];
+          rem -= c;
+      }
+      return t.rankHash[h];
+  }
+
+  FullHandRank decodeHandStrength(const HandStrength s) {
+      if( s == 0 ) return FullHandRank();
+      return FullHandRank(tables().strengthToKey[s - 1]);
+  }
+
+}
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include "handbuckets.h"
+#include "evaluator.h"
+#include "hash.h"
+#include "holecards.h"
+#include "isomorphism.h"
+#include "rng.h"
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    constexpr char kMagic[4] = { 'H', 'B', 'K', 'T' };
+    constexpr int kNumHands = HoleCards::kNumHands;
+    constexpr int kBoardCards[HandBuckets::kNumStreets] = { 0, 3, 4, 5 };
+    constexpr int kNumPreflopClasses = 169;
+    constexpr size_t kBoardsPerChunk = 16;
+    constexpr size_t kPointsPerChunk = 4096;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t numBuckets[HandBuckets::kNumStreets];
+        uint64_t size[HandBuckets::kNumStreets];
+    };
+
+    const HoleCards& kHoles = HoleCards::all();
+
+    const HandIndexer& boardIndexer(const int street) {
+        // The boards alone, up to suits; street 0 has the empty board only
+        static const HandIndexer indexers[3] = { HandIndexer({3}), HandIndexer({4}), HandIndexer({5}) };
+        return indexers[street - 1];
+    }
+    uint64_t numBoards(const int street) { return street == 0 ? 1 : boardIndexer(street).size(); }
+    CardSet boardOf(const int street, const uint64_t index) {
+        if( street == 0 ) return CardSet();
+        CardSet board;
+        boardIndexer(street).unindex(index, &board);
+        return board;
+    }
+
+    Rng boardRng(const HandBuckets::Settings& settings, const int street, const uint64_t board) {
+        // Fitting and assigning see the same runouts of a board
+        return Rng(settings.seed * 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(street) << 40 ^ board);
+    }
+
+    void riverEquity(const CardSet& board, float ehs[]) {
+        // Exact equity against one random hand, ties counting half, of every hand that fits a five-card board
+        constexpr float kOpponents = 45 * 44 / 2;
+        uint16_t order[kNumHands];
+        HandStrength strength[kNumHands];
+        int beats[kNumHands];
+        const int n = rankRiverHands(board, strength, order);
+        sweepByStrength(order, n, strength, [](int) { return 1; }, [&beats, ehs](const int pass, const int h, const int other) {
+            if( pass == 0 ) beats[h] = other;
+            else ehs[h] = (beats[h] + 0.5f * (kOpponents - beats[h] - other)) / kOpponents;
+        });
+    }
+
+    template<typename F>
+    void forEachCompletion(const int* cards, const int numCards, const int need, const CardSet& partial, F&& f) {
+        // Every way to add need of the cards to partial
+        if( need == 0 ) return f(partial);
+        for(int i = 0; i + need <= numCards; i++)
+            forEachCompletion(cards + i + 1, numCards - i - 1, need - 1, partial | CardSet::fromIndex(cards[i]), f);
+    }
+
+    double choose(const int n, const int k) {
+        double c = 1.0;
+        for(int i = 0; i < k; i++) c = c * (n - i) / (i + 1);
+        return c;
+    }
+
+    class Features {
+        // Feature vector of every hand that fits a board of the street
+        public:
+            Features(const HandBuckets::Settings& settings, const int street) : settings(settings), street(street) {
+                histogram = street < 3 and settings.feature == HandBuckets::Feature::Histogram;
+                metric = histogram ? settings.metric : HandBuckets::Metric::L2;
+                dim = histogram ? settings.histogramBins : 1;
+            }
+
+            int dim;
+            HandBuckets::Metric metric;
+
+            // Appends the hands that fit board to holes and their features to x
+            void operator()(const CardSet& board, Rng& rng, std::vector<uint16_t>& holes, std::vector<float>& x) const {
+                const size_t first = holes.size();
+                int slot[kNumHands];
+                for(int h = 0; h < kNumHands; h++) {
+                    slot[h] = -1;
+                    if( kHoles.set[h].intersects(board) ) continue;
+                    slot[h] = holes.size() - first;
+                    holes.push_back(h);
+                }
+                const size_t n = holes.size() - first;
+                x.resize(x.size() + n * dim, 0.0f);
+                float* out = x.data() + first * dim;
+
+                float ehs[kNumHands];
+                if( street == 3 ) {
+                    riverEquity(board, ehs);
+                    for(int h = 0; h < kNumHands; h++)
+                        if( slot[h] >= 0 ) out[slot[h]] = ehs[h];
+                    return;
+                }
+
+                std::vector<int> seen(n, 0);
+                auto addRunout = [&](const CardSet& full) {
+                    riverEquity(full, ehs);
+                    for(int h = 0; h < kNumHands; h++) {
+                        if( slot[h] < 0 or kHoles.set[h].intersects(full) ) continue;
+                        float* f = out + slot[h] * dim;
+                        if( histogram ) f[std::min(dim - 1, static_cast<int>(ehs[h] * dim))] += 1.0f;
+                        else f[0] += settings.feature == HandBuckets::Feature::EHS2 ? ehs[h] * ehs[h] : ehs[h];
+                        seen[slot[h]]++;
+                    }
+                };
+                const int need = 5 - kBoardCards[street];
+                const int left = 52 - kBoardCards[street];
+                if( choose(left, need) <= settings.runouts ) {
+                    int cards[52];
+                    int numCards = 0;
+                    board.complement().forEachIndex([&](const int i) { cards[numCards++] = i; });
+                    forEachCompletion(cards, numCards, need, board, addRunout);
+                }
+                else {
+                    Deck deck;
+                    for(int r = 0; r < settings.runouts; r++) {
+                        deck.reset(board);
+                        addRunout(board | deck.pop_cards(rng, need));
+                    }
+                }
+
+                // Normalize; histograms compared by earth mover's distance are kept as their CDF, where it is plain L1
+                for(size_t i = 0; i < n; i++) {
+                    float* f = out + i * dim;
+                    const float scale = seen[i] ? 1.0f / seen[i] : 0.0f;
+                    float cumulative = 0.0f;
+                    for(int d = 0; d < dim; d++) {
+                        f[d] *= scale;
+                        if( metric == HandBuckets::Metric::EMD ) f[d] = cumulative += f[d];
+                    }
+                }
+            }
+
+            // Mean river equity of a feature vector (EHS^2 stays squared, which orders the same)
+            float equity(const float* f) const {
+                if( !histogram ) return f[0];
+                float mean = 0.0f;
+                for(int d = 0; d < dim; d++) {
+                    const float p = metric == HandBuckets::Metric::EMD ? f[d] - (d ? f[d - 1] : 0.0f) : f[d];
+                    mean += p * (d + 0.5f) / dim;
+                }
+                return mean;
+            }
+
+        private:
+            const HandBuckets::Settings& settings;
+            const int street;
+            bool histogram;
+    };
+
+    float distance(const float* a, const float* b, const int dim, const HandBuckets::Metric metric) {
+        float d = 0.0f;
+        for(int i = 0; i < dim; i++) {
+            const float diff = a[i] - b[i];
+            d += metric == HandBuckets::Metric::EMD ? std::abs(diff) : diff * diff;
+        }
+        return d;
+    }
+
+    int nearest(const float* x, const std::vector<float>& centers, const int dim, const HandBuckets::Metric metric) {
+        int best = 0;
+        float bestDistance = std::numeric_limits<float>::max();
+        for(size_t c = 0; c * dim < centers.size(); c++) {
+            const float d = distance(x, centers.data() + c * dim, dim, metric);
+            if( d < bestDistance ) {
+                bestDistance = d;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    std::vector<float> kmeans(const std::vector<float>& x, const std::vector<float>& weight, const int dim, int k,
+                              const HandBuckets::Metric metric, const int iterations, Rng& rng) {
+        // Weighted k-means++ seeding followed by Lloyd's algorithm; returns the centers, at most one per point.
+        // Assignments run on the pool, center updates serially, so the result depends only on rng
+        const size_t n = weight.size();
+        k = std::min<size_t>(k, n);
+        const size_t nChunks = (n + kPointsPerChunk - 1) / kPointsPerChunk;
+        auto parallelPoints = [nChunks, n](auto&& f) {
+            ThreadPool::instance().parallelFor(nChunks, [&](const size_t c) {
+                for(size_t i = c * kPointsPerChunk; i < std::min(n, (c + 1) * kPointsPerChunk); i++) f(i);
+            });
+        };
+        auto pick = [&rng, n](const std::vector<double>& mass) {
+            double total = 0.0;
+            for(const double m : mass) total += m;
+            if( total <= 0.0 ) return static_cast<size_t>(boundedRandom(rng, n));
+            double u = rng.uniform() * total;
+            for(size_t i = 0; i < n; i++)
+                if( (u -= mass[i]) < 0.0 ) return i;
+            return n - 1;
+        };
+
+        std::vector<float> centers;
+        std::vector<double> mass(weight.begin(), weight.end());
+        std::vector<float> closest(n, std::numeric_limits<float>::max());
+        for(int c = 0; c < k; c++) {
+            const size_t chosen = pick(mass);
+            centers.insert(centers.end(), x.begin() + chosen * dim, x.begin() + (chosen + 1) * dim);
+            const float* center = centers.data() + c * dim;
+            parallelPoints([&](const size_t i) {
+                closest[i] = std::min(closest[i], distance(x.data() + i * dim, center, dim, metric));
+                mass[i] = weight[i] * closest[i];
+            });
+        }
+
+        std::vector<int> assigned(n, -1);
+        for(int it = 0; it < iterations; it++) {
+            std::atomic<bool> changed { false };
+            parallelPoints([&](const size_t i) {
+                const int c = nearest(x.data() + i * dim, centers, dim, metric);
+                if( c != assigned[i] ) {
+                    assigned[i] = c;
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            });
+            if( !changed ) break;
+            std::vector<double> sum(centers.size(), 0.0), total(k, 0.0);
+            for(size_t i = 0; i < n; i++) {
+                total[assigned[i]] += weight[i];
+                for(int d = 0; d < dim; d++) sum[assigned[i] * dim + d] += weight[i] * x[i * dim + d];
+            }
+            for(int c = 0; c < k; c++) {
+                if( total[c] <= 0.0 ) continue;        // an empty cluster keeps its center
+                for(int d = 0; d < dim; d++) centers[c * dim + d] = sum[c * dim + d] / total[c];
+            }
+        }
+        return centers;
+    }
+  }
+
+  HandBuckets::Feature HandBuckets::parseFeature(const std::string& name) {
+      if( name == "ehs" ) return Feature::EHS;
+      if( name == "ehs2" ) return Feature::EHS2;
+      if( name == "histogram" ) return Feature::Histogram;
+      throw std::invalid_argument("unknown bucket feature " + name);
+  }
+
+  HandBuckets::Metric HandBuckets::parseMetric(const std::string& name) {
+      if( name == "l2" ) return Metric::L2;
+      if( name == "emd" ) return Metric::EMD;
+      throw std::invalid_argument("unknown bucket metric " + name);
+  }
+
+  HandBuckets HandBuckets::build(const Settings& settings) {
+      for(const int k : settings.buckets)
+          if( k < 0 or k > kMaxBuckets ) throw std::invalid_argument("HandBuckets: bucket counts must be in [0, 256]");
+      if( settings.histogramBins <= 0 or settings.runouts <= 0 or settings.trainingBoards <= 0 or settings.iterations < 0 )
+          throw std::invalid_argument("HandBuckets: bins, runouts and training boards must be positive");
+
+      HandBuckets hb;
+      for(int street = 0; street < kNumStreets; street++) {
+          const int k = settings.buckets[street];
+          if( k == 0 ) continue;
+          const HandIndexer& indexer = HandIndexer::forStreet(street);
+          std::vector<uint8_t>& table = hb.table[street];
+          table.assign(indexer.size(), 0);
+          if( street == 0 and k >= kNumPreflopClasses ) {
+              // One bucket per starting hand loses nothing
+              for(uint64_t i = 0; i < indexer.size(); i++) table[i] = i;
+              hb.numBuckets[street] = kNumPreflopClasses;
+              continue;
+          }
+          const Features features(settings, street);
+          const int dim = features.dim;
+
+          // Fit to the hands of random boards, each board weighted by how often it was drawn
+          Rng rng(settings.seed + street);
+          std::map<uint64_t, int> drawn;
+          Deck deck;
+          for(int b = 0; b < (street == 0 ? 1 : settings.trainingBoards); b++) {
+              deck.reset();
+              const CardSet board = deck.pop_cards(rng, kBoardCards[street]);
+              drawn[street == 0 ? 0 : boardIndexer(street).index(&board)]++;
+          }
+          const std::vector<std::pair<uint64_t, int>> boards(drawn.begin(), drawn.end());
+          std::vector<std::vector<uint16_t>> boardHoles(boards.size());
+          std::vector<std::vector<float>> boardX(boards.size());
+          ThreadPool::instance().parallelFor(boards.size(), [&](const size_t b) {
+              Rng boardStream = boardRng(settings, street, boards[b].first);
+              features(boardOf(street, boards[b].first), boardStream, boardHoles[b], boardX[b]);
+          });
+          std::vector<float> x, weight;
+          for(size_t b = 0; b < boards.size(); b++) {
+              x.insert(x.end(), boardX[b].begin(), boardX[b].end());
+              weight.insert(weight.end(), boardHoles[b].size(), boards[b].second);
+          }
+          const std::vector<float> fitted = kmeans(x, weight, dim, k, features.metric, settings.iterations, rng);
+          hb.numBuckets[street] = fitted.size() / dim;
+
+          // Number the buckets from the weakest center to the strongest
+          std::vector<int> byEquity(hb.numBuckets[street]);
+          for(size_t c = 0; c < byEquity.size(); c++) byEquity[c] = c;
+          std::stable_sort(byEquity.begin(), byEquity.end(), [&](const int a, const int b) {
+              return features.equity(fitted.data() + a * dim) < features.equity(fitted.data() + b * dim);
+          });
+          std::vector<float> centers;
+          for(const int c : byEquity) centers.insert(centers.end(), fitted.begin() + c * dim, fitted.begin() + (c + 1) * dim);
+
+          // Assign every hand of every board. A hand's index is reached from one canonical board only,
+          // so no two chunks write the same entry
+          const uint64_t nBoards = numBoards(street);
+          const size_t nChunks = (nBoards + kBoardsPerChunk - 1) / kBoardsPerChunk;
+          ThreadPool::instance().parallelFor(nChunks, [&](const size_t c) {
+              std::vector<uint16_t> holes;
+              std::vector<float> fx;
+              for(uint64_t b = c * kBoardsPerChunk; b < std::min<uint64_t>(nBoards, (c + 1) * kBoardsPerChunk); b++) {
+                  const CardSet board = boardOf(street, b);
+                  Rng boardStream = boardRng(settings, street, b);
+                  holes.clear();
+                  fx.clear();
+                  features(board, boardStream, holes, fx);
+                  for(size_t i = 0; i < holes.size(); i++)
+                      table[indexer.index(kHoles.set[holes[i]], board)] = nearest(fx.data() + i * dim, centers, dim, features.metric);
+              }
+          });
+      }
+      hb.rehash();
+      return hb;
+  }
+
+  int HandBuckets::bucket(const CardSet& hole, const CardSet& board) const {
+      const int street = board.size() == 0 ? 0 : static_cast<int>(board.size()) - 2;
+      if( board.size() == 1 or board.size() == 2 or !covers(street) ) return -1;
+      return table[street][HandIndexer::forStreet(street).index(hole, board)];
+  }
+
+  bool HandBuckets::save(const std::string& path) const {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      if( !out ) return false;
+      FileHeader header;
+      std::memcpy(header.magic, kMagic, sizeof(kMagic));
+      header.version = kVersion;
+      for(int street = 0; street < kNumStreets; street++) {
+          header.numBuckets[street] = numBuckets[street];
+          header.size[street] = table[street].size();
+      }
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for(const auto& t : table) out.write(reinterpret_cast<const char*>(t.data()), t.size());
+      return bool(out);
+  }
+
+  bool HandBuckets::load(const std::string& path) {
+      std::ifstream in(path, std::ios::binary);
+      if( !in ) return false;
+      FileHeader header;
+      if( !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ) return false;
+      if( std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 or header.version != kVersion ) return false;
+      decltype(table) loaded;
+      for(int street = 0; street < kNumStreets; street++) {
+          const uint64_t expected = header.numBuckets[street] ? HandIndexer::forStreet(street).size() : 0;
+          if( header.numBuckets[street] > kMaxBuckets or header.size[street] != expected ) return false;
+          loaded[street].resize(expected);
+          if( !in.read(reinterpret_cast<char*>(loaded[street].data()), expected) ) return false;
+          for(const uint8_t b : loaded[street])
+              if( b >= header.numBuckets[street] ) return false;
+      }
+      for(int street = 0; street < kNumStreets; street++) numBuckets[street] = header.numBuckets[street];
+      table = std::move(loaded);
+      rehash();
+      return true;
+  }
+
+  void HandBuckets::rehash() {
+      // Never kNoBuckets, so a bucketed policy can't pass for an unbucketed one
+      uint64_t h = fnv1a(numBuckets.data(), sizeof(numBuckets));
+      for(const auto& t : table) h = fnv1a(t.data(), t.size(), h);
+      hash = h == kNoBuckets ? 1 : h;
+  }
+
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include "headsup.h"
+
+namespace Poker {
+
+  HeadsUpState HeadsUpState::start(const HeadsUpSettings& settings) {
+      HeadsUpState s;
+      s.committed[0] = settings.smallBlind;
+      s.committed[1] = settings.bigBlind;
+      s.lastMove[0] = s.lastMove[1] = BPM::Call;          // blinds are posted as calls
+      s.minimumBet = s.minimumBetBeforePass = settings.bigBlind;
+      s.nextToAct();
+      return s;
+  }
+
+  void HeadsUpState::nextToAct() {
+      // Same order as Game::doRound: each pass visits the players still betting, and a pass that changed
+      // the minimum bet is followed by another one on the same street
+      while( !terminal() ) {
+          for(toAct++; toAct < 2; toAct++)
+              if( betting(toAct) ) return;
+          if( minimumBet == minimumBetBeforePass ) street++;
+          minimumBetBeforePass = minimumBet;
+          toAct = -1;
+      }
+  }
+
+  void HeadsUpState::legalActions(const HeadsUpSettings& settings, bool legal[]) const {
+      // Folding is always allowed, as it is in Game::doRound
+      legal[static_cast<int>(BPM::Fold)] = true;
+      legal[static_cast<int>(BPM::Call)] = true;
+      legal[static_cast<int>(BPM::Raise)] = 2 * minimumBet < settings.stack;
+      legal[static_cast<int>(BPM::AllIn)] = settings.stack > minimumBet;
+  }
+
+  HeadsUpState HeadsUpState::apply(const HeadsUpSettings& settings, const int a) const {
+      HeadsUpState next = *this;
+      const int seat = toAct;
+      switch( static_cast<BPM>(a) ) {
+          case BPM::Fold:
+              next.folded[seat] = true;
+              break;
+          case BPM::Call:
+              next.committed[seat] = next.minimumBet;
+              break;
+          case BPM::Raise:
+              next.minimumBet *= 2;
+              next.committed[seat] = next.minimumBet;
+              break;
+          case BPM::AllIn:
+              next.committed[seat] = settings.stack;
+              next.minimumBet = std::max(next.minimumBet, settings.stack);
+              next.allIn[seat] = true;
+              break;
+          default:
+              break;
+      }
+      next.lastMove[seat] = static_cast<BPM>(a);
+      next.nextToAct();
+      return next;
+  }
+
+  CFRAI1::InfosetKey HeadsUpState::key(const int seat, const int handClass) const {
+      CFRAI1::ReducedGameState rgs;
+      rgs.position = kSeatPosition[seat];
+      rgs.street = street;
+      rgs.handClass = handClass;
+      rgs.lastMove.fill(BPM::Undef);
+      for(int i = 0; i < 2; i++) {
+          const int pos = static_cast<int>(kSeatPosition[i]);
+          rgs.lastMove[pos] = lastMove[i];
+          rgs.seated |= 1u << pos;
+      }
+      return rgs.key();
+  }
+
+}
@@ -0,0 +1,38 @@
+#include <algorithm>
+#include "holecards.h"
+
+namespace Poker {
+  namespace {
+    HoleCards enumerate() {
+        HoleCards hands;
+        int n = 0;
+        CardSet::fullDeck().forEachIndex([&hands, &n](const int i) {
+            CardSet::fullDeck().forEachIndex([&hands, &n, i](const int j) {
+                if( j <= i ) return;
+                hands.set[n] = CardSet::fromIndex(i) | CardSet::fromIndex(j);
+                hands.card[n][0] = i;
+                hands.card[n][1] = j;
+                n++;
+            });
+        });
+        return hands;
+    }
+  }
+
+  const HoleCards& HoleCards::all() {
+      static const HoleCards hands = enumerate();
+      return hands;
+  }
+
+  int rankRiverHands(const CardSet& board, HandStrength strength[HoleCards::kNumHands], uint16_t order[HoleCards::kNumHands]) {
+      const HoleCards& hands = HoleCards::all();
+      int n = 0;
+      for(int h = 0; h < HoleCards::kNumHands; h++) {
+          if( hands.set[h].intersects(board) ) continue;
+          strength[h] = evaluateHand(hands.set[h] | board);
+          order[n++] = h;
+      }
+      std::sort(order, order + n, [strength](const uint16_t a, const uint16_t b) { return strength[a] < strength[b]; });
+      return n;
+  }
+}
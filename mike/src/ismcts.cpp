@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "game.h"
+#include "strategy.h"
+#include "tableview.h"
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    using BPM = CFRAI1::BinnedPlayerMove;
+    constexpr int kNumActions = CFRAI1::kNumBinnedMoves;
+
+    struct Node {
+        // Statistics of the moves out of one node, indexed by BinnedPlayerMove
+        int child[kNumActions] = { -1, -1, -1, -1 };
+        uint32_t visits[kNumActions] = {};
+        uint32_t available[kNumActions] = {};      // iterations in which the move was legal here
+        double reward[kNumActions] = {};           // big blinds won by the seat making the move
+    };
+
+    void legalMoves(const Game::Decision& d, bool legal[]) {
+        // The binned moves VecEnv allows, less folding when there is nothing to call
+        legal[static_cast<int>(BPM::Fold)] = d.committed < d.minimumBet;
+        legal[static_cast<int>(BPM::Call)] = d.canCall();
+        legal[static_cast<int>(BPM::Raise)] = 2 * d.minimumBet < d.bankroll;
+        legal[static_cast<int>(BPM::AllIn)] = true;
+    }
+
+    PlayerMove checkOrCall(const Game::Decision& d) {
+        // The rollout policy, as SingleMoveCallAI plays
+        return d.canCall() ? PlayerMove(Move::MOVE_CALL, d.minimumBet) : PlayerMove(Move::MOVE_ALLIN, d.bankroll);
+    }
+
+    bool buildGame(const TableView& info, const GameState& hand, Game& game, int& me) {
+        // A private Game in the state the real one is in, from the hand state the player is shown.
+        // The players in the hand are the seats with chips, in betting order, as Game::setNonBRPlayersPositions
+        // chose them; false if that doesn't match the engine's state or it isn't this player's turn
+        std::vector<TableView::Seat> seats;
+        info.forEachSeat([&seats](const TableView::Seat& s) { if( s.bankroll > 0 ) seats.push_back(s); });
+        std::sort(seats.begin(), seats.end(), [](const TableView::Seat& a, const TableView::Seat& b) { return a.position < b.position; });
+        if( int(seats.size()) != hand.numSeats or hand.over ) return false;
+
+        Table table;
+        table.bigBlind = info.bigBlind();
+        table.smallBlind = info.smallBlind();
+        me = -1;
+        for(size_t seat = 0; seat < seats.size(); seat++) {
+            auto P = make_shared<Player>();
+            P->playerID = seats[seat].playerID;
+            P->setPosition(seats[seat].position);
+            P->bankroll = seats[seat].bankroll;
+            P->move = seats[seat].move;
+            if( P->playerID == info.self().playerID ) me = seat;
+            table.playerList.push_back(P);
+        }
+        game = Game(table);
+        game.activePlayers = game.table.playerList;
+        game.bettingPlayers = game.table.playerList;
+        game.state = hand;
+        if( me < 0 or game.seatToAct() != me ) return false;
+        game.bettingPlayers[me]->hand = info.self().hand;
+        game.table.communityCards = hand.board;
+        return true;
+    }
+
+    class Tree {
+        public:
+            Tree(Game&& root, const int me, const double exploration, const Rng& rng)
+                : game(std::move(root)), me(me), exploration(exploration), rng(rng) {
+                start = game.snapshot();
+                nodes.emplace_back();
+            }
+
+            void iterate() {
+                game.restore(start);
+                determinize();
+                path.clear();
+                int node = 0;
+                bool inTree = true;
+                while( !game.state.over ) {
+                    const Game::Decision d = game.pendingDecision();
+                    if( !inTree ) {
+                        game.applyMove(checkOrCall(d));
+                        continue;
+                    }
+                    bool legal[kNumActions];
+                    legalMoves(d, legal);
+                    const int a = select(node, legal);
+                    path.push_back(Step { node, a, d.seat });
+                    if( nodes[node].child[a] < 0 ) {
+                        // one new node per iteration, then the rollout
+                        nodes[node].child[a] = nodes.size();
+                        nodes.emplace_back();
+                        inTree = false;
+                    }
+                    node = nodes[node].child[a];
+                    game.applyMove(CFRAI1::unpackBinnedPlayerMove(static_cast<BPM>(a), d.minimumBet, d.bankroll));
+                }
+                for(const Step& s : path) {
+                    Node& n = nodes[s.node];
+                    n.visits[s.action]++;
+                    n.reward[s.action] += double(game.bettingPlayers[s.seat]->bankroll - start.state.stack[s.seat]) / game.table.bigBlind;
+                }
+            }
+
+            const Node& root() const { return nodes[0]; }
+
+        private:
+            struct Step {
+                int node;
+                int action;
+                int seat;
+            };
+            Game game;
+            GameSnapshot start;
+            const int me;
+            const double exploration;
+            Rng rng;
+            std::vector<Node> nodes;
+            std::vector<Step> path;
+
+            void determinize() {
+                // Deals every other seat hole cards from what the player can't see, and the deck the rest of the board comes from
+                CardSet dead = start.state.board | start.state.hole[me];
+                Deck deck(dead);
+                for(int seat = 0; seat < game.state.numSeats; seat++) {
+                    if( seat == me ) continue;
+                    const CardSet hole = deck.pop_cards(rng, 2);
+                    game.state.hole[seat] = hole;
+                    game.bettingPlayers[seat]->hand = hole;
+                    dead = dead | hole;
+                }
+                game.table.resetDeck(dead);
+                game.table.rng = rng.split();
+            }
+
+            int select(const int node, const bool legal[]) {
+                // An untried legal move at random if there is one, else UCB1 counting only the iterations a move was available in
+                Node& n = nodes[node];
+                int untried[kNumActions];
+                int numUntried = 0;
+                for(int a = 0; a < kNumActions; a++) {
+                    if( !legal[a] ) continue;
+                    n.available[a]++;
+                    if( n.visits[a] == 0 ) untried[numUntried++] = a;
+                }
+                if( numUntried > 0 ) return untried[boundedRandom(rng, numUntried)];
+
+                int best = -1;
+                double bestScore = -std::numeric_limits<double>::infinity();
+                for(int a = 0; a < kNumActions; a++) {
+                    if( !legal[a] ) continue;
+                    const double score = n.reward[a] / n.visits[a] + exploration * std::sqrt(std::log(double(n.available[a])) / n.visits[a]);
+                    if( score > bestScore ) {
+                        bestScore = score;
+                        best = a;
+                    }
+                }
+                return best;
+            }
+    };
+  }
+
+  PlayerMove ISMCTSAI::makeMove(const TableView& info) {
+      const Player& p = info.self();
+      const PlayerMove call = p.bankroll > info.minimumBet() ? PlayerMove(Move::MOVE_CALL, info.minimumBet()) : PlayerMove(Move::MOVE_ALLIN, p.bankroll);
+      GameState hand;
+      if( !info.handState(hand) ) return call;
+
+      Game root;
+      int me;
+      if( !buildGame(info, hand, root, me) ) return call;
+      const Game::Decision decision = root.pendingDecision();
+      bool legal[kNumActions];
+      legalMoves(decision, legal);
+
+      const int numTrees = threads > 0 ? threads : ThreadPool::instance().concurrency();
+      std::vector<Rng> streams;
+      for(int t = 0; t < numTrees; t++) streams.push_back(rng.split());
+      std::vector<std::array<uint32_t, kNumActions>> visits(numTrees);
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(secondsPerMove);
+      const bool timed = secondsPerMove > 0.0;
+      const auto searching = [&]() { return timed ? std::chrono::steady_clock::now() < deadline : maxIterations > 0; };
+      auto budget = [&](const size_t t) -> uint64_t {
+          return maxIterations > 0 ? maxIterations * (t + 1) / numTrees - maxIterations * t / numTrees : std::numeric_limits<uint64_t>::max();
+      };
+      auto plant = [&](const size_t t) {
+          Game game;
+          int seat;
+          buildGame(info, hand, game, seat);
+          return Tree(std::move(game), seat, exploration, streams[t]);
+      };
+
+      if( ThreadPool::inParallelFor() ) {
+          // Called from a parallel loop (a bench playing games on the pool): waiting there would run unrelated
+          // queued work past the deadline, so the trees take turns on this thread instead
+          std::vector<Tree> trees;
+          for(int t = 0; t < numTrees; t++) trees.push_back(plant(t));
+          std::vector<uint64_t> done(numTrees, 0);
+          for(bool more = true; more and searching(); ) {
+              more = false;
+              for(int t = 0; t < numTrees; t++) {
+                  if( done[t] >= budget(t) ) continue;
+                  trees[t].iterate();
+                  more = ++done[t] < budget(t) or more;
+              }
+          }
+          for(int t = 0; t < numTrees; t++) std::copy(trees[t].root().visits, trees[t].root().visits + kNumActions, visits[t].begin());
+      }
+      else {
+          // Root parallelism: independent trees, each searching until the deadline, their root visits added up at the end.
+          // A tree that only starts after the deadline, or whose share of maxIterations is zero, does nothing
+          ThreadPool::instance().parallelFor(numTrees, [&](const size_t t) {
+              Tree tree = plant(t);
+              for(uint64_t i = 0; i < budget(t) and searching(); i++) tree.iterate();
+              std::copy(tree.root().visits, tree.root().visits + kNumActions, visits[t].begin());
+          });
+      }
+
+      int best = static_cast<int>(BPM::Call);
+      uint64_t bestVisits = 0;
+      for(int a = 0; a < kNumActions; a++) {
+          uint64_t total = 0;
+          for(const auto& v : visits) total += v[a];
+          if( legal[a] and total > bestVisits ) {
+              bestVisits = total;
+              best = a;
+          }
+      }
+      if( bestVisits == 0 ) return call;
+      return CFRAI1::unpackBinnedPlayerMove(static_cast<BPM>(best), decision.minimumBet, decision.bankroll);
+  }
+
+  void ISMCTSAI::updateParameters(const std::vector<std::any>& params) {
+      if( params.size() > 0 ) secondsPerMove = std::any_cast<double>(params[0]);
+      if( params.size() > 1 ) exploration = std::any_cast<double>(params[1]);
+  }
+
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "isomorphism.h"
+
+namespace Poker {
+  namespace {
+    constexpr int kNumSuits = 4;
+    constexpr int kNumRanks = 13;
+    constexpr int kMaxRounds = 4;               // counts are packed a nibble per round into 16 bits per suit
+    constexpr uint32_t kRankMask = 0x1fff;
+
+    uint64_t binomial(const uint64_t n, const uint64_t k) {
+        if( k > n ) return 0;
+        unsigned __int128 c = 1;
+        for(uint64_t i = 1; i <= k; i++)
+            c = c * (n - k + i) / i;
+        return static_cast<uint64_t>(c);
+    }
+
+    struct SmallBinomials {
+        // C(n, k) for n, k <= 13, the only ones the per-suit patterns need
+        uint32_t c[kNumRanks + 1][kNumRanks + 1] = {};
+        constexpr SmallBinomials() {
+            for(int n = 0; n <= kNumRanks; n++) {
+                c[n][0] = 1;
+                for(int k = 1; k <= n; k++) c[n][k] = c[n - 1][k - 1] + (k < n ? c[n - 1][k] : 0);
+            }
+        }
+    };
+    constexpr SmallBinomials kChoose;
+
+    uint64_t multichoose(const uint64_t n, const uint64_t k) {
+        // multisets of size k drawn from n values
+        return n == 0 ? (k == 0) : binomial(n + k - 1, k);
+    }
+
+    uint32_t countAt(const uint32_t counts, const int round, const int numRounds) {
+        return (counts >> (4 * (numRounds - 1 - round))) & 0xf;
+    }
+
+    uint32_t compress(const uint32_t ranks, const uint32_t used) {
+        // Positions of ranks among the ranks not yet used by this suit
+        uint32_t out = 0;
+        for(uint32_t m = ranks; m; m &= m - 1) {
+            const int r = __builtin_ctz(m);
+            out |= 1u << __builtin_popcount(~used & kRankMask & ((1u << r) - 1));
+        }
+        return out;
+    }
+
+    uint32_t expand(const uint32_t positions, const uint32_t used) {
+        uint32_t out = 0;
+        int position = 0;
+        for(int r = 0; r < kNumRanks; r++) {
+            if( used & (1u << r) ) continue;
+            if( positions & (1u << position) ) out |= 1u << r;
+            position++;
+        }
+        return out;
+    }
+
+    uint64_t colexRank(const uint32_t set) {
+        uint64_t rank = 0;
+        int i = 1;
+        for(uint32_t m = set; m; m &= m - 1)
+            rank += kChoose.c[__builtin_ctz(m)][i++];
+        return rank;
+    }
+
+    uint32_t colexUnrank(uint64_t rank, const int k) {
+        uint32_t set = 0;
+        for(int i = k; i >= 1; i--) {
+            int b = kNumRanks - 1;
+            while( kChoose.c[b][i] > rank ) b--;
+            set |= 1u << b;
+            rank -= kChoose.c[b][i];
+        }
+        return set;
+    }
+
+    uint64_t multisetRank(const uint64_t* descending, const int m) {
+        // a_1 >= ... >= a_m becomes the strictly decreasing b_i = a_i + m - i, ranked in the combinatorial number system
+        if( m == 1 ) return descending[0];
+        uint64_t rank = 0;
+        for(int i = 0; i < m; i++)
+            rank += binomial(descending[i] + (m - 1 - i), m - i);
+        return rank;
+    }
+
+    void multisetUnrank(uint64_t rank, const int m, const uint64_t numValues, uint64_t* descending) {
+        for(int i = 0; i < m; i++) {
+            const int k = m - i;
+            // largest b with C(b, k) <= rank
+            uint64_t lo = k - 1, hi = numValues + k - 1;
+            while( lo < hi ) {
+                const uint64_t mid = lo + (hi - lo + 1) / 2;
+                if( binomial(mid, k) <= rank ) lo = mid;
+                else hi = mid - 1;
+            }
+            rank -= binomial(lo, k);
+            descending[i] = lo - (m - 1 - i);
+        }
+    }
+
+    struct SuitPattern {
+        uint32_t counts;
+        uint64_t pattern;
+        bool operator>(const SuitPattern& o) const {
+            return counts != o.counts ? counts > o.counts : pattern > o.pattern;
+        }
+    };
+  }
+
+  HandIndexer::HandIndexer(const std::vector<int>& cardsPerRound_in) : cardsPerRound(cardsPerRound_in) {
+      int numCards = 0;
+      for(const int c : cardsPerRound) numCards += c;
+      if( cardsPerRound.empty() or numRounds() > kMaxRounds or numCards > 52 )
+          throw std::invalid_argument("HandIndexer: unsupported rounds");
+
+      std::vector<uint64_t> keys;
+      uint32_t counts[kNumSuits] = {};
+      enumerateConfigurations(0, 0, cardsPerRound[0], counts, keys);
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+      for(const uint64_t key : keys) {
+          Configuration config;
+          config.key = key;
+          config.offset = total;
+          config.size = 1;
+          for(int s = 0; s < kNumSuits; s++) {
+              const uint32_t c = (key >> (16 * (kNumSuits - 1 - s))) & 0xffff;
+              if( !config.groups.empty() and config.groups.back().counts == c ) {
+                  config.groups.back().numSuits++;
+              } else {
+                  config.groups.push_back(Group { c, 1, numPatterns(c), 0 });
+              }
+          }
+          for(Group& g : config.groups) {
+              g.size = multichoose(g.numPatterns, g.numSuits);
+              config.size *= g.size;
+          }
+          total += config.size;
+          configurations.emplace_back(std::move(config));
+      }
+  }
+
+  void HandIndexer::enumerateConfigurations(const int round, const int suit, const int left, uint32_t counts[], std::vector<uint64_t>& keys) const {
+      // Deals every split of each round's cards over the suits, keeping the canonical (sorted) one
+      if( suit == kNumSuits ) {
+          if( left != 0 ) return;
+          if( round + 1 < numRounds() ) {
+              enumerateConfigurations(round + 1, 0, cardsPerRound[round + 1], counts, keys);
+              return;
+          }
+          uint32_t sorted[kNumSuits];
+          std::copy(counts, counts + kNumSuits, sorted);
+          std::sort(sorted, sorted + kNumSuits, std::greater<uint32_t>());
+          uint64_t key = 0;
+          for(const uint32_t c : sorted) key = (key << 16) | c;
+          keys.push_back(key);
+          return;
+      }
+      int held = 0;
+      for(int r = 0; r < round; r++) held += countAt(counts[suit], r, round);
+      for(int c = 0; c <= left and held + c <= kNumRanks; c++) {
+          const uint32_t saved = counts[suit];
+          counts[suit] = (counts[suit] << 4) | c;
+          enumerateConfigurations(round, suit + 1, left - c, counts, keys);
+          counts[suit] = saved;
+      }
+  }
+
+  uint64_t HandIndexer::numPatterns(const uint32_t counts) const {
+      uint64_t n = 1;
+      int used = 0;
+      for(int r = 0; r < numRounds(); r++) {
+          const int c = countAt(counts, r, numRounds());
+          n *= binomial(kNumRanks - used, c);
+          used += c;
+      }
+      return n;
+  }
+
+  const HandIndexer& HandIndexer::forStreet(const int street) {
+      static const HandIndexer indexers[4] = {
+          HandIndexer({2}), HandIndexer({2, 3}), HandIndexer({2, 4}), HandIndexer({2, 5})
+      };
+      return indexers[street];
+  }
+
+  uint64_t HandIndexer::index(const CardSet& hole, const CardSet& board) const {
+      const CardSet rounds[2] = { hole, board };
+      return index(rounds);
+  }
+
+  uint64_t HandIndexer::index(const CardSet* rounds) const {
+      SuitPattern suits[kNumSuits];
+      for(int s = 0; s < kNumSuits; s++) {
+          uint32_t used = 0;
+          uint32_t counts = 0;
+          uint64_t pattern = 0;
+          uint64_t radix = 1;
+          for(int r = 0; r < numRounds(); r++) {
+              const uint32_t ranks = rounds[r].suitMask(s);
+              const int c = __builtin_popcount(ranks);
+              counts = (counts << 4) | c;
+              pattern += radix * colexRank(compress(ranks, used));
+              radix *= kChoose.c[kNumRanks - __builtin_popcount(used)][c];
+              used |= ranks;
+          }
+          suits[s] = SuitPattern { counts, pattern };
+      }
+      std::sort(suits, suits + kNumSuits, std::greater<SuitPattern>());
+
+      uint64_t key = 0;
+      for(const SuitPattern& sp : suits) key = (key << 16) | sp.counts;
+      const auto config = std::lower_bound(configurations.begin(), configurations.end(), key,
+                                           [](const Configuration& c, const uint64_t k) { return c.key < k; });
+      if( config == configurations.end() or config->key != key )
+          throw std::invalid_argument("HandIndexer: cards don't match the rounds");
+
+      uint64_t idx = 0;
+      int s = 0;
+      for(const Group& g : config->groups) {
+          uint64_t patterns[kNumSuits];
+          for(int i = 0; i < g.numSuits; i++) patterns[i] = suits[s + i].pattern;
+          idx = idx * g.size + multisetRank(patterns, g.numSuits);
+          s += g.numSuits;
+      }
+      return config->offset + idx;
+  }
+
+  void HandIndexer::unindex(uint64_t idx, CardSet* rounds) const {
+      if( idx >= total ) throw std::out_of_range("HandIndexer: index out of range");
+      const auto config = std::upper_bound(configurations.begin(), configurations.end(), idx,
+                                           [](const uint64_t i, const Configuration& c) { return i < c.offset; }) - 1;
+      idx -= config->offset;
+
+      // Groups were combined first to last, so the last one is the least significant digit
+      uint64_t groupIndex[kNumSuits];
+      for(int g = static_cast<int>(config->groups.size()) - 1; g >= 0; g--) {
+          groupIndex[g] = idx % config->groups[g].size;
+          idx /= config->groups[g].size;
+      }
+
+      for(int r = 0; r < numRounds(); r++) rounds[r].clear();
+      int s = 0;
+      for(size_t g = 0; g < config->groups.size(); g++) {
+          const Group& group = config->groups[g];
+          uint64_t patterns[kNumSuits];
+          multisetUnrank(groupIndex[g], group.numSuits, group.numPatterns, patterns);
+          for(int i = 0; i < group.numSuits; i++, s++) {
+              uint64_t pattern = patterns[i];
+              uint32_t used = 0;
+              for(int r = 0; r < numRounds(); r++) {
+                  const int c = countAt(group.counts, r, numRounds());
+                  const uint64_t combos = kChoose.c[kNumRanks - __builtin_popcount(used)][c];
+                  const uint32_t ranks = expand(colexUnrank(pattern % combos, c), used);
+                  pattern /= combos;
+                  rounds[r] |= CardSet(uint64_t(ranks) << (16 * s));
+                  used |= ranks;
+              }
+          }
+      }
+  }
+
+}
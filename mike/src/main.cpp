@@ -11,9 +11,96 @@
 #include "game.h"
 #include "bench.h"
 #include "pybindings.h"
+#include "preflop.h"
+#include "mccfr.h"
+#include "bestresponse.h"
+#include "handbuckets.h"
+#include "selfcheck.h"
 
 using namespace Poker;
-int main() {
+int main(int argc, char** argv) {
+    if( argc > 1 and std::string(argv[1]) == "selfcheck" ) {
+        // poker selfcheck [samples]: checks the hand evaluator and the hand indexer against slow reference versions
+        const uint64_t samples = argc > 2 ? std::stoull(argv[2]) : 100000;
+        const bool ok = selfCheckEvaluator(std::cout, samples) and selfCheckHandIndexer(std::cout, samples);
+        std::cout << (ok ? "self check passed" : "self check FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    if( argc > 1 and std::string(argv[1]) == "preflop" ) {
+        // poker preflop [file] [tolerance]: builds the preflop equity table MattAI reads on street 0
+        const std::string out = argc > 2 ? argv[2] : "preflop_equity.bin";
+        PrecisionTarget target;
+        target.tolerance = argc > 3 ? std::stod(argv[3]) : 0.001;
+        target.maxSamples = 1 << 24;
+        auto start = std::chrono::steady_clock::now();
+        const PreflopTable table = PreflopTable::generate(target);
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        if( !table.save(out) ) {
+            std::cerr << "could not write " << out << std::endl;
+            return 1;
+        }
+        std::cout << "preflop table written to " << out << " in " << duration.count() << " seconds" << std::endl;
+        table.printChart(std::cout, 1);
+        return 0;
+    }
+    if( argc > 1 and std::string(argv[1]) == "buckets" ) {
+        // poker buckets [file] [flop] [turn] [river] [feature] [metric]: clusters hands into a card abstraction for
+        // CFR, one bucket per starting hand preflop and the given number of buckets (0 for none) after
+        HandBuckets::Settings settings;
+        const std::string out = argc > 2 ? argv[2] : "hand_buckets.bin";
+        for(int street = 1; street < HandBuckets::kNumStreets; street++)
+            if( argc > street + 2 ) settings.buckets[street] = std::stoi(argv[street + 2]);
+        if( argc > 6 ) settings.feature = HandBuckets::parseFeature(argv[6]);
+        if( argc > 7 ) settings.metric = HandBuckets::parseMetric(argv[7]);
+        auto start = std::chrono::steady_clock::now();
+        const HandBuckets buckets = HandBuckets::build(settings);
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        if( !buckets.save(out) ) {
+            std::cerr << "could not write " << out << std::endl;
+            return 1;
+        }
+        std::cout << "hand buckets written to " << out << " in " << duration.count() << " seconds" << std::endl;
+        return 0;
+    }
+    if( argc > 1 and std::string(argv[1]) == "cfr" ) {
+        // poker cfr [iterations] [file] [variant] [buckets]: trains a heads-up CFRAI1 policy with MCCFR, writes its
+        // table and reports how exploitable it is. With a hand bucket file the policy uses that card abstraction
+        const uint64_t iterations = argc > 2 ? std::stoull(argv[2]) : 1000000;
+        const std::string out = argc > 3 ? argv[3] : "cfr_policy.bin";
+        MCCFRTrainer::Settings settings;
+        if( argc > 4 ) settings.rule.variant = parseCFRVariant(argv[4]);
+        if( argc > 5 ) {
+            auto buckets = std::make_shared<HandBuckets>();
+            if( !buckets->load(argv[5]) ) {
+                std::cerr << argv[5] << " is missing or not a valid hand bucket file" << std::endl;
+                return 1;
+            }
+            settings.buckets = buckets;
+        }
+        MCCFRTrainer trainer(settings);
+        auto start = std::chrono::steady_clock::now();
+        const double value = trainer.train(iterations);
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        CFRAI1 ai;
+        trainer.exportPolicy(ai);
+        ai.dumpCFRTableToFile(out);
+        std::cout << iterations << " iterations in " << duration.count() << " seconds, " << trainer.numInfosets()
+                  << " infosets, small blind value " << value << " chips/hand; policy written to " << out << std::endl;
+        BestResponse::Settings brSettings;
+        static_cast<HeadsUpSettings&>(brSettings) = settings;
+        brSettings.buckets = settings.buckets;
+        const Exploitability e = BestResponse(brSettings).exploitability(BestResponse::policyOf(trainer));
+        std::cout << "exploitability " << e.mbbPerHand << " mbb/hand (best response " << e.bestResponse[0]
+                  << " as small blind, " << e.bestResponse[1] << " as big blind)" << std::endl;
+        return 0;
+    }
+    if( argc > 2 and std::string(argv[1]) == "verify" ) {
+        // poker verify file: checks a CFR policy file's checksum, which loading it skips so that it starts instantly
+        StrategyFile file;
+        const bool ok = file.open(argv[2], true);
+        std::cout << argv[2] << (ok ? " is a valid policy file with " + std::to_string(file.size()) + " entries" : " is missing, not a policy file or corrupt") << std::endl;
+        return ok ? 0 : 1;
+    }
     /*
     constexpr int N = 2000;
     constexpr int writeevery = 1000;
@@ -63,26 +150,8 @@ int main() {
     //benchmarkHandRankCalculator(1000000);
 
 
-    // Calculates pre-flop ranges
-    /*
-    vector<Suit> suitlist = { Suit::HEART, Suit::CLUB, Suit::DIAMOND, Suit::SPADE};
-    for(int j=0; j<13; j++) 
-        std::cout << std::setw(10) << static_cast<Rank>(j) << " ";
-    std::cout << std::endl;
-    for(int i=0; i<13; i++) {
-        std::cout << static_cast<Rank>(i) << " ";
-        for(int j=0; j<13; j++) {
-            Card c1(static_cast<Rank>(i), Suit::HEART);
-            Card c2(static_cast<Rank>(j), Suit::HEART);
-            std::vector<Card> myCards = { c1, c2 };
-            auto [WR, var] = monteCarloSingleHandStdDev(myCards, 5, 1, 5000);
-            std::cout << std::fixed;
-            std::cout << std::setprecision(2) << std::setw(10);
-            std::cout << WR << " (" << var << ")";
-        }
-        std::cout << std::endl;
-    }
-    */
+    // Pre-flop ranges: run "poker preflop" to build the table, then
+    //if( const PreflopTable* preflop = preflopTable() ) preflop->printChart(std::cout, 1);
 
 
     return 0;
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <stdexcept>
+#include "mccfr.h"
+#include "evaluator.h"
+#include "showdown.h"
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    constexpr int kNumActions = MCCFRTrainer::kNumActions;
+    constexpr int kNumStreets = HeadsUpState::kNumStreets;
+    constexpr uint64_t kIterationsPerChunk = 256;
+
+    using RegretTable = InfosetTable<2 * kNumActions>;
+
+    struct Deal {
+        // Everything about the cards a traversal needs, worked out once
+        int handClass[2][kNumStreets];          // per seat, per street
+        HandStrength strength[2];
+    };
+
+    Deal deal(Rng& rng, const HandBuckets* buckets) {
+        Deck deck;
+        Deal d;
+        const CardSet hole[2] = { deck.pop_cards(rng, 2), deck.pop_cards(rng, 2) };
+        CardSet board;
+        for(int street = 0; street < kNumStreets; street++) {
+            board |= deck.pop_cards(rng, street == 1 ? 3 : street > 1 ? 1 : 0);
+            for(int seat = 0; seat < 2; seat++)
+                d.handClass[seat][street] = CFRAI1::handClassOf(hole[seat], board, buckets);
+        }
+        for(int seat = 0; seat < 2; seat++)
+            d.strength[seat] = evaluateHand(hole[seat] | board);
+        return d;
+    }
+
+    class Traversal {
+        public:
+            Traversal(RegretTable& table, const MCCFRTrainer::Settings& settings, Rng& rng) : table(table), settings(settings), rng(rng) {}
+
+            bool prune = false;         // whether this traversal skips actions with very negative regret
+
+            double operator()(const HeadsUpState& s, const Deal& d, const int traverser) {
+                if( s.terminal() ) return s.utility(traverser, d.strength[traverser], d.strength[1 - traverser]);
+
+                const int seat = s.toAct;
+                bool legal[kNumActions];
+                s.legalActions(settings, legal);
+                auto slot = table.findOrInsert(s.key(seat, d.handClass[seat][s.street])).first;
+                if( !slot ) throw std::runtime_error("MCCFRTrainer: infoset table is full");
+
+                float regrets[kNumActions], sigma[kNumActions];
+                for(int a = 0; a < kNumActions; a++) regrets[a] = slot->values[a].load(std::memory_order_relaxed);
+                RegretRule::regretMatching(regrets, legal, kNumActions, sigma);
+
+                if( seat == traverser ) {
+                    // Explore every action and accumulate the regret of not having taken it.
+                    // A pruned action is neither explored nor updated, unless that would leave nothing to explore
+                    bool explore[kNumActions];
+                    bool any = false;
+                    for(int a = 0; a < kNumActions; a++) {
+                        explore[a] = legal[a] and !(prune and settings.rule.prunable(regrets[a]));
+                        any = any or explore[a];
+                    }
+                    if( !any ) std::copy(legal, legal + kNumActions, explore);
+
+                    // The node value weighs the explored actions by the strategy renormalised over them, so a pruned
+                    // action that still has some weight (when every regret is negative and the strategy is uniform)
+                    // doesn't count as a zero and drag the value down
+                    double u[kNumActions] = {};
+                    double node = 0.0;
+                    double exploredWeight = 0.0;
+                    for(int a = 0; a < kNumActions; a++) {
+                        if( !explore[a] ) continue;
+                        u[a] = (*this)(s.apply(settings, a), d, traverser);
+                        node += sigma[a] * u[a];
+                        exploredWeight += sigma[a];
+                    }
+                    if( exploredWeight > 0.0 ) node /= exploredWeight;
+                    for(int a = 0; a < kNumActions; a++) {
+                        if( !explore[a] ) continue;
+                        const double delta = u[a] - node;
+                        RegretTable::update(slot->values[a], [this, delta](const float r) { return static_cast<float>(settings.rule.accumulate(r, delta)); });
+                    }
+                    return node;
+                }
+
+                // The opponent samples a single action; its strategy counts towards the average here
+                for(int a = 0; a < kNumActions; a++)
+                    if( legal[a] ) RegretTable::add(slot->values[kNumActions + a], sigma[a]);
+                const double choice = rng.uniform();
+                double partialSum = 0.0;
+                int chosen = -1;
+                for(int a = 0; a < kNumActions; a++) {
+                    if( !legal[a] ) continue;
+                    chosen = a;
+                    partialSum += sigma[a];
+                    if( choice < partialSum ) break;
+                }
+                return (*this)(s.apply(settings, chosen), d, traverser);
+            }
+
+        private:
+            RegretTable& table;
+            const MCCFRTrainer::Settings& settings;
+            Rng& rng;
+    };
+
+  }
+
+  MCCFRTrainer::MCCFRTrainer(const Settings& settings_in) : settings(settings_in), table(1 << 16) {
+      if( settings.smallBlind <= 0 or settings.bigBlind < settings.smallBlind or settings.stack <= settings.bigBlind )
+          throw std::invalid_argument("MCCFRTrainer: need 0 < small blind <= big blind < stack");
+      if( settings.iterationsPerDiscount == 0 )
+          throw std::invalid_argument("MCCFRTrainer: iterationsPerDiscount must be positive");
+  }
+
+  double MCCFRTrainer::train(const uint64_t iterations, Rng& rng) {
+      double total = 0.0;
+      for(uint64_t done = 0; done < iterations; ) {
+          const uint64_t batch = std::min(settings.iterationsPerDiscount, iterations - done);
+          const bool pruning = settings.rule.pruningEnabled(numIterations);
+          const std::vector<double> chunks = runInChunks<double>(batch, kIterationsPerChunk, rng, [this, pruning](Rng& r, const uint64_t n) {
+              Traversal traverse(table, settings, r);
+              const HeadsUpState root = HeadsUpState::start(settings);
+              double value = 0.0;
+              for(uint64_t iN = 0; iN < n; iN++) {
+                  traverse.prune = pruning and r.uniform() < settings.rule.pruneProbability;
+                  // The small blind's value estimate, and minus the big blind's
+                  value += traverse(root, deal(r, settings.buckets.get()), 0);
+                  value -= traverse(root, deal(r, settings.buckets.get()), 1);
+              }
+              return value;
+          });
+          for(const double v : chunks) total += v;
+          done += batch;
+          numIterations += batch;
+          discount();
+          if( table.needsGrowth() ) table.grow();
+      }
+      return iterations ? total / (2.0 * iterations) : 0.0;
+  }
+
+  void MCCFRTrainer::discount() {
+      // Runs between batches, when no traversal is touching the table
+      const RegretRule::Discount d = settings.rule.discountAfter(++numDiscounts);
+      if( d.identity() ) return;
+      table.forEachSlot([&d](RegretTable::Slot& slot) {
+          for(int a = 0; a < kNumActions; a++) {
+              const float r = slot.values[a].load(std::memory_order_relaxed);
+              slot.values[a].store(r * static_cast<float>(r > 0.0f ? d.positive : d.negative), std::memory_order_relaxed);
+              const float w = slot.values[kNumActions + a].load(std::memory_order_relaxed);
+              slot.values[kNumActions + a].store(w * static_cast<float>(d.strategy), std::memory_order_relaxed);
+          }
+      });
+  }
+
+  std::array<float, MCCFRTrainer::kNumActions> MCCFRTrainer::averageStrategy(const Key key) const {
+      std::array<float, kNumActions> avg;
+      avg.fill(1.0f / kNumActions);
+      const auto slot = table.find(key);
+      if( !slot ) return avg;
+      float sum = 0.0f;
+      for(int a = 0; a < kNumActions; a++) sum += slot->values[kNumActions + a].load(std::memory_order_relaxed);
+      if( sum <= 0.0f ) return avg;
+      for(int a = 0; a < kNumActions; a++) avg[a] = slot->values[kNumActions + a].load(std::memory_order_relaxed) / sum;
+      return avg;
+  }
+
+  void MCCFRTrainer::exportPolicy(CFRAI1& ai) const {
+      ai.handBuckets = settings.buckets;
+      ai.CFRTable.clear();
+      ai.CFRTable.reserve(2 * table.size());
+      table.forEach([this, &ai](const Key key, const std::array<float, 2 * kNumActions>&) {
+          const auto avg = averageStrategy(key);
+          auto slot = ai.CFRTable.findOrInsert(key).first;
+          for(int a = 0; a < kNumActions; a++) slot->values[a].store(avg[a], std::memory_order_relaxed);
+      });
+  }
+
+}
@@ -1,5 +1,6 @@
 #include "player.h"
 #include "strategy.h"
+#include "tableview.h"
 #include <random>
 
 namespace Poker{
@@ -7,10 +8,10 @@ namespace Poker{
     Player::Player(int p)  { playerID = p; };
     Player::Player(int pos, int pID) { position = static_cast<PlayerPosition>(pos); playerID = pID; }
     
-    PlayerMove Player::makeMove(shared_ptr<Table> info) {
+    PlayerMove Player::makeMove(const Table& table, const GameState* hand) {
         if ( not strategy ) 
             strategy = make_unique<Strategy>();
-        PlayerMove move = strategy->makeMove(info, make_shared<Player>(*this));
+        PlayerMove move = strategy->makeMove(TableView(table, *this, hand));
         this->move = move;
         return move;
     }
@@ -25,8 +26,7 @@ namespace Poker{
             {Move::MOVE_UNDEF, "undef! "}
         };
         std::cout << "Player " << player.playerID << " (" << PlayerPosition_to_String[player.position] << ") "  << ": ";
-        std::vector<Card> pHand = player.hand;
-        std::cout << pHand;
+        std::cout << player.hand;
         std::cout << strMap[move] << pmove.bet_amount << " (bank: " << player.bankroll << ")" << std::endl;
     }
 
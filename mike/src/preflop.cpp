@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include "preflop.h"
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    constexpr char kMagic[4] = { 'P', 'F', 'E', 'Q' };
+    constexpr const char* kDefaultTableFile = "preflop_equity.bin";
+    constexpr const char* kRankChars = "23456789TJQKA";
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t numClasses;
+        uint32_t maxOpponents;
+    };
+  }
+
+  int preflopClass(const CardSet& hole) {
+      if( hole.size() != 2 ) return -1;
+      const int a = __builtin_ctzll(hole.mask);
+      const int b = 63 - __builtin_clzll(hole.mask);
+      const int ra = a & 15, rb = b & 15;
+      const int hi = std::max(ra, rb), lo = std::min(ra, rb);
+      const bool suited = (a >> 4) == (b >> 4);
+      return suited ? 13 * hi + lo : 13 * lo + hi;
+  }
+
+  CardSet preflopClassHand(const int cls) {
+      const int row = cls / 13, col = cls % 13;
+      if( row > col ) return CardSet::fromIndex(row) | CardSet::fromIndex(col);     // suited, both clubs
+      return CardSet::fromIndex(row) | CardSet::fromIndex(16 + col);                // pair or offsuit, club and diamond
+  }
+
+  std::string preflopClassName(const int cls) {
+      const int row = cls / 13, col = cls % 13;
+      std::string name { kRankChars[std::max(row, col)], kRankChars[std::min(row, col)] };
+      if( row > col ) name += 's';
+      else if( row < col ) name += 'o';
+      return name;
+  }
+
+  PreflopTable PreflopTable::generate(const PrecisionTarget& target, Rng& rng) {
+      // One pool task per (class, opponents) entry, each with its own stream so the table is reproducible
+      constexpr size_t numEntries = kNumPreflopClasses * kMaxOpponents;
+      std::vector<Rng> streams;
+      streams.reserve(numEntries);
+      for(size_t e = 0; e < numEntries; e++)
+          streams.emplace_back(rng.split());
+
+      PreflopTable t;
+      ThreadPool::instance().parallelFor(numEntries, [&](const size_t e) {
+          const int cls = e / kMaxOpponents;
+          const int opponents = e % kMaxOpponents + 1;
+          t.table[cls][opponents - 1] = equityToPrecision(preflopClassHand(cls), CardSet(), opponents, target, streams[e]).share;
+      });
+      return t;
+  }
+
+  bool PreflopTable::save(const std::string& path) const {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      if( !out ) return false;
+      FileHeader header;
+      std::memcpy(header.magic, kMagic, sizeof(kMagic));
+      header.version = kVersion;
+      header.numClasses = kNumPreflopClasses;
+      header.maxOpponents = kMaxOpponents;
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char*>(table.data()), sizeof(table));
+      return bool(out);
+  }
+
+  bool PreflopTable::load(const std::string& path) {
+      std::ifstream in(path, std::ios::binary);
+      if( !in ) return false;
+      FileHeader header;
+      if( !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ) return false;
+      if( std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 or header.version != kVersion
+          or header.numClasses != kNumPreflopClasses or header.maxOpponents != kMaxOpponents ) return false;
+      decltype(table) loaded;
+      if( !in.read(reinterpret_cast<char*>(loaded.data()), sizeof(loaded)) ) return false;
+      table = loaded;
+      return true;
+  }
+
+  void PreflopTable::printChart(std::ostream& os, const int numOpponents) const {
+      // Same layout as preflopClass, aces first
+      const std::ios_base::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      os << std::fixed << std::setprecision(3);
+      os << "   ";
+      for(int col = 12; col >= 0; col--) os << std::setw(7) << kRankChars[col];
+      os << std::endl;
+      for(int row = 12; row >= 0; row--) {
+          os << kRankChars[row] << "  ";
+          for(int col = 12; col >= 0; col--)
+              os << std::setw(7) << equity(13 * row + col, numOpponents);
+          os << std::endl;
+      }
+      os.flags(flags);
+      os.precision(precision);
+  }
+
+  const PreflopTable* preflopTable() {
+      static const std::unique_ptr<PreflopTable> loaded = []() -> std::unique_ptr<PreflopTable> {
+          const char* env = std::getenv("POKER_PREFLOP_TABLE");
+          auto t = std::make_unique<PreflopTable>();
+          if( t->load(env ? env : kDefaultTableFile) ) return t;
+          return nullptr;
+      }();
+      return loaded.get();
+  }
+
+}
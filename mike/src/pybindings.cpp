@@ -1,17 +1,27 @@
 
 #include <memory>
 #include "bench.h"
+#include "bestresponse.h"
+#include "equity.h"
 #include "game.h"
+#include "handbuckets.h"
+#include "mccfr.h"
+#include "regret.h"
 #include "table.h"
+#include "threadpool.h"
+#include "vecenv.h"
 #include <chrono>
 #include <fstream>
 #include <any>
+#include <limits>
+#include <stdexcept>
 
 
 #define PYTHON false
 #if PYTHON
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #endif
 
 
@@ -20,7 +30,6 @@ namespace Poker {
 
 void pyMonteCarloGames(const uint64_t& N) {
     vector<string> aiList = {"CFRAI1", "rand"};
-    std::random_device rd;
     auto myTable = Table();
     // populate player list
     myTable.setPlayerList(aiList);
@@ -42,15 +51,15 @@ void pyMonteCarloGames(const uint64_t& N) {
     int nRounds = 0;
     while( iN < N ) {
       iN++;
-      myTable.resetCards(rd);
+      myTable.resetCards();
       game->table.setPlayerBankrolls(startingCash);
       game->setup();
       game->moveRecord.clear();
-      game->tableRecord.clear();
+      game->record.clear();
       game->printMovesToRecord = false;
       auto nPlayers = game->bettingPlayers.size();
       while( nPlayers > 1) {
-          game->table.resetCards(rd);
+          game->table.resetCards();
           game->doRound();  
           game->setNonBRPlayersPositions(1);
           nPlayers = game->bettingPlayers.size();
@@ -69,9 +78,9 @@ void pyMonteCarloGames(const uint64_t& N) {
       //          FOR EACH PLAYER IN ACTIVEPLAYERS
       //            bankroll
       auto BB = (double)myTable.bigBlind;
-      for(size_t i=0; i<game->tableRecord.size(); i++ ) {
-        auto curTable = game->tableRecord[i];
-        myFile << curTable.pot / BB << ",";
+      for(size_t i=0; i<game->record.size(); i++ ) {
+        const GameSnapshot& cur = game->record[i];
+        myFile << cur.state.pot / BB << ",";
         for(auto& P : game->activePlayers) {
           auto Pmoves = game->moveRecord[P];
           // If player left bettingPlayers during the round, keep printing their last move.
@@ -135,36 +144,214 @@ std::vector<std::tuple<int, int>> convertMikeToCharles(std::vector<Card> in) {
   return out;
 }
 
+CardSet convertCharlesToCardSet(const std::vector<std::tuple<int,int>>& in) {
+  // Charles's ranks 2-14 are our rank lanes 0-12 and his suits 1-4 (S, H, D, C) our suit lanes 3, 2, 1, 0.
+  // Cards outside those are skipped
+  CardSet out;
+  for(auto& pair : in) {
+    const int charlesRank = get<0>(pair);
+    const int charlesSuit = get<1>(pair);
+    if( charlesRank < 2 or charlesRank > 14 or charlesSuit < 1 or charlesSuit > 4 ) continue;
+    out.insertIndex(16 * (4 - charlesSuit) + charlesRank - 2);
+  }
+  return out;
+}
+
+std::vector<std::tuple<int, int>> convertCardSetToCharles(const CardSet& in) {
+  std::vector<std::tuple<int, int>> out;
+  in.forEachIndex([&out](int i) { out.emplace_back((i & 15) + 2, 4 - (i >> 4)); });
+  return out;
+}
+
 int pyShowdownHands(std::vector<std::tuple<int,int>> tupleIntsA, std::vector<std::tuple<int,int>> tupleIntsB, 
                     std::vector<std::tuple<int,int>> communityTupleInts) {
   // returns 0 if A won, 1 if B won, 2 if draw
-  vector<Card> cardsA;
-  vector<Card> cardsB;
-  vector<Card> commCardsA;
-  vector<Card> commCardsB;
-
-  cardsA = convertCharlesToMike(tupleIntsA);
-  cardsB = convertCharlesToMike(tupleIntsB);
-  commCardsA = convertCharlesToMike(communityTupleInts);
-  commCardsB = commCardsA;
-
-  // append community cards 
-  commCardsA.insert(commCardsA.end(), cardsA.begin(), cardsA.end());
-  commCardsB.insert(commCardsB.end(), cardsB.begin(), cardsB.end());
-
-  auto fhrA = calcFullHandRank(commCardsA);
-  auto fhrB = calcFullHandRank(commCardsB);
-  auto showdownResult = showdownFHR(fhrA, fhrB);
-  if(showdownResult == fhrA) return 0;
-  else if(showdownResult == fhrB) return 1;
+  const CardSet commCards = convertCharlesToCardSet(communityTupleInts);
+  auto fhrA = calcFullHandRank(convertCharlesToCardSet(tupleIntsA) | commCards);
+  auto fhrB = calcFullHandRank(convertCharlesToCardSet(tupleIntsB) | commCards);
+  if(fhrA > fhrB) return 0;
+  else if(fhrB > fhrA) return 1;
   else return 2;
 }
 
 double pyMCSingleHand(const std::vector<std::tuple<int,int>>& cardsA, const std::vector<std::tuple<int,int>>& commCards, const int numOtherPlayers, const uint64_t N) {
-  auto [avg, sigma] = monteCarloSingleHand(convertCharlesToMike(cardsA), convertCharlesToMike(commCards), numOtherPlayers, N);
+  auto [avg, sigma] = monteCarloSingleHand(convertCharlesToCardSet(cardsA), convertCharlesToCardSet(commCards), numOtherPlayers, N);
   return avg;
 }
 
+std::tuple<double,double,double,bool> pyEquity(const std::vector<std::tuple<int,int>>& cardsA, const std::vector<std::tuple<int,int>>& commCards, const int numOtherPlayers, const uint64_t N) {
+  // (win, tie, loss, exact) against random hands with the board run out
+  const EquityResult r = equityVsRandom(convertCharlesToCardSet(cardsA), convertCharlesToCardSet(commCards), numOtherPlayers, N);
+  return std::make_tuple(r.win, r.tie, r.loss, r.exact);
+}
+
+std::tuple<double,double,uint64_t> pyEquityToPrecision(const std::vector<std::tuple<int,int>>& cardsA, const std::vector<std::tuple<int,int>>& commCards, const int numOtherPlayers, const double tolerance, const double maxSeconds) {
+  // (equity, standard error, samples used) sampled until the 95% interval is within tolerance or time runs out
+  PrecisionTarget target;
+  target.tolerance = tolerance;
+  target.maxSeconds = maxSeconds;
+  const EquityResult r = equityToPrecision(convertCharlesToCardSet(cardsA), convertCharlesToCardSet(commCards), numOtherPlayers, target);
+  return std::make_tuple(r.share, r.standardError, r.samples);
+}
+
+std::vector<int> pyEncodeCards(const std::vector<std::tuple<int,int>>& cards) {
+  // Charles's (rank, suit) pairs as the card codes the batch functions take: 4 * (rank - 2) + suit - 1
+  std::vector<int> out;
+  for(auto& pair : cards) out.push_back(4 * (get<0>(pair) - 2) + get<1>(pair) - 1);
+  return out;
+}
+
+CardSet codesToCardSet(const int32_t* codes, const size_t k) {
+  // One row of card codes; negative codes are empty slots, e.g. board cards not dealt yet
+  CardSet out;
+  for(size_t i = 0; i < k; i++) {
+    if( codes[i] < 0 ) continue;
+    if( codes[i] >= 52 ) throw std::invalid_argument("card codes run from 0 to 51");
+    const CardSet card = CardSet::fromIndex(16 * (3 - (codes[i] & 3)) + (codes[i] >> 2));
+    if( out.intersects(card) ) throw std::invalid_argument("a row holds the same card twice");
+    out = out | card;
+  }
+  return out;
+}
+
+void evaluateHandsBatch(const int32_t* cards, const size_t n, const size_t k, uint16_t* strength) {
+  // strength[r] = HandStrength of row r of the n x k array of codes
+  constexpr size_t kRowsPerChunk = 4096;
+  ThreadPool::instance().parallelFor((n + kRowsPerChunk - 1) / kRowsPerChunk, [&](const size_t c) {
+    const size_t end = std::min(n, (c + 1) * kRowsPerChunk);
+    for(size_t r = c * kRowsPerChunk; r < end; r++) strength[r] = evaluateHand(codesToCardSet(cards + r * k, k));
+  });
+}
+
+void showdownHandsBatch(const int32_t* cardsA, const int32_t* cardsB, const int32_t* board, const size_t n, const size_t kBoard, int8_t* result) {
+  // showdownHands for every row: 0 if A won, 1 if B won, 2 if draw
+  constexpr size_t kRowsPerChunk = 4096;
+  ThreadPool::instance().parallelFor((n + kRowsPerChunk - 1) / kRowsPerChunk, [&](const size_t c) {
+    const size_t end = std::min(n, (c + 1) * kRowsPerChunk);
+    for(size_t r = c * kRowsPerChunk; r < end; r++) {
+      const CardSet commCards = codesToCardSet(board + r * kBoard, kBoard);
+      const HandStrength a = evaluateHand(codesToCardSet(cardsA + 2 * r, 2) | commCards);
+      const HandStrength b = evaluateHand(codesToCardSet(cardsB + 2 * r, 2) | commCards);
+      result[r] = a > b ? 0 : b > a ? 1 : 2;
+    }
+  });
+}
+
+void equityBatch(const int32_t* cards, const size_t n, const size_t k, const int numOtherPlayers, const uint64_t N, double* wtl) {
+  // Row r holds two hole cards then the board; wtl[3r..3r+2] = its (win, tie, loss) against random hands.
+  // Every row has its own stream split off threadRng, so a seeded batch gives the same answer on any number of threads
+  std::vector<Rng> streams;
+  streams.reserve(n);
+  for(size_t r = 0; r < n; r++) streams.emplace_back(threadRng().split());
+  ThreadPool::instance().parallelFor(n, [&](const size_t r) {
+    const EquityResult e = equityVsRandom(codesToCardSet(cards + r * k, 2), codesToCardSet(cards + r * k + 2, k - 2), numOtherPlayers, N, streams[r]);
+    wtl[3 * r] = e.win;
+    wtl[3 * r + 1] = e.tie;
+    wtl[3 * r + 2] = e.loss;
+  });
+}
+
+static std::shared_ptr<const HandBuckets> loadHandBuckets(const std::string& bucketfile) {
+  // nullptr for no file, meaning ReducedFullHandRank classes
+  if( bucketfile.empty() ) return nullptr;
+  auto buckets = std::make_shared<HandBuckets>();
+  if( !buckets->load(bucketfile) ) throw std::runtime_error(bucketfile + " is missing or not a valid hand bucket file");
+  return buckets;
+}
+
+std::tuple<double,uint64_t> pyTrainCFR(const uint64_t iterations, const std::string& outfile, const int stack, const int smallBlind, const int bigBlind,
+                                       const RegretRule& rule, const std::string& bucketfile) {
+  // (small blind's value in chips/hand, infosets) after training; the CFRAI1 policy is written to outfile
+  MCCFRTrainer::Settings settings;
+  settings.stack = stack;
+  settings.smallBlind = smallBlind;
+  settings.bigBlind = bigBlind;
+  settings.rule = rule;
+  settings.buckets = loadHandBuckets(bucketfile);
+  MCCFRTrainer trainer(settings);
+  const double value = trainer.train(iterations);
+  CFRAI1 ai;
+  trainer.exportPolicy(ai);
+  ai.dumpCFRTableToFile(outfile);
+  return std::make_tuple(value, trainer.numInfosets());
+}
+
+std::tuple<double,double,double> pyExploitability(const std::string& policyfile, const int stack, const int smallBlind, const int bigBlind,
+                                                  const int flops, const int turnsPerFlop, const int riversPerTurn, const uint64_t seed,
+                                                  const std::string& bucketfile) {
+  // (mbb/hand, best response as small blind, as big blind) against the CFRAI1 policy in policyfile
+  BestResponse::Settings settings;
+  settings.stack = stack;
+  settings.smallBlind = smallBlind;
+  settings.bigBlind = bigBlind;
+  settings.flops = flops;
+  settings.turnsPerFlop = turnsPerFlop;
+  settings.riversPerTurn = riversPerTurn;
+  settings.seed = seed;
+  settings.buckets = loadHandBuckets(bucketfile);
+  CFRAI1 ai;
+  ai.handBuckets = settings.buckets;
+  ai.loadCFRTableFromFile(policyfile);
+  const Exploitability e = BestResponse(settings).exploitability(BestResponse::policyOf(ai));
+  return std::make_tuple(e.mbbPerHand, e.bestResponse[0], e.bestResponse[1]);
+}
+
+void pyBuildHandBuckets(const std::string& outfile, const std::array<int, HandBuckets::kNumStreets>& buckets, const std::string& feature,
+                        const std::string& metric, const int histogramBins, const int runouts, const int trainingBoards, const int iterations,
+                        const uint64_t seed) {
+  HandBuckets::Settings settings;
+  settings.buckets = buckets;
+  settings.feature = HandBuckets::parseFeature(feature);
+  settings.metric = HandBuckets::parseMetric(metric);
+  settings.histogramBins = histogramBins;
+  settings.runouts = runouts;
+  settings.trainingBoards = trainingBoards;
+  settings.iterations = iterations;
+  settings.seed = seed;
+  if( !HandBuckets::build(settings).save(outfile) ) throw std::runtime_error("could not write " + outfile);
+}
+
+RegretRule pyRegretRule(const std::string& variant, const double alpha, const double beta, const double gamma,
+                        const double pruneThreshold, const uint64_t pruneAfter, const double pruneProbability) {
+  RegretRule rule;
+  rule.variant = parseCFRVariant(variant);
+  rule.alpha = alpha;
+  rule.beta = beta;
+  rule.gamma = gamma;
+  rule.pruneThreshold = pruneThreshold;
+  rule.pruneAfter = pruneAfter;
+  rule.pruneProbability = pruneProbability;
+  return rule;
+}
+
+std::vector<float> pyRegretStrategy(const RegretRule&, const std::vector<float>& regretSum) {
+  // Current strategy of an infoset from its regret sums
+  std::vector<float> strategy(regretSum.size());
+  RegretRule::regretMatching(regretSum.data(), nullptr, regretSum.size(), strategy.data());
+  return strategy;
+}
+
+std::vector<float> pyRegretAccumulate(const RegretRule& rule, std::vector<float> regretSum, const std::vector<float>& regrets) {
+  // regretSum plus this iteration's (already weighted) regrets, floored at zero under CFR+
+  if( regrets.size() != regretSum.size() ) throw std::invalid_argument("regretSum and regrets differ in length");
+  for(size_t a = 0; a < regretSum.size(); a++) regretSum[a] = rule.accumulate(regretSum[a], regrets[a]);
+  return regretSum;
+}
+
+std::tuple<std::vector<float>, std::vector<float>> pyRegretDiscount(const RegretRule& rule, std::vector<float> regretSum, std::vector<float> strategySum, const uint64_t iteration) {
+  // Both sums after the rule's discount for the iteration that just finished (counting from 1)
+  const RegretRule::Discount d = rule.discountAfter(iteration);
+  for(float& r : regretSum) r *= r > 0.0f ? d.positive : d.negative;
+  for(float& w : strategySum) w *= d.strategy;
+  return std::make_tuple(regretSum, strategySum);
+}
+
+std::vector<bool> pyRegretPrunable(const RegretRule& rule, const std::vector<float>& regretSum) {
+  std::vector<bool> out;
+  for(const float r : regretSum) out.push_back(rule.prunable(r));
+  return out;
+}
+
 double pyMonteCarloRounds(const uint64_t& N, std::vector<double> mattParams) {
     auto AIList = std::multimap<std::string, std::vector<std::any>>();
     std::vector<std::any> mattParamsAny;
@@ -178,8 +365,108 @@ double pyMonteCarloRounds(const uint64_t& N, std::vector<double> mattParams) {
     return avg;
 }
 
+std::tuple<std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>>
+pyMonteCarloDuplicateRounds(const uint64_t& N, const std::vector<std::vector<double>>& candidates) {
+    // Matt with each threshold vector against a caller on duplicate deals.
+    // Returns (mean, standard error) of the winnings and of the difference from the first candidate
+    auto AIList = std::multimap<std::string, std::vector<std::any>>();
+    AIList.emplace("Matt", std::vector<std::any>{});
+    AIList.emplace("call", std::vector<std::any>{});
+    std::vector<std::vector<std::any>> candidatesAny;
+    for( const auto& params : candidates )
+      candidatesAny.emplace_back(params.begin(), params.end());
+    const DuplicateResult result = monteCarloDuplicateRounds(N, candidatesAny, AIList);
+    std::vector<double> mean, stderror, diff, diffStderror;
+    for( size_t c = 0; c < candidates.size(); c++ ) {
+      mean.push_back(result.winnings[c].mean());
+      stderror.push_back(result.winnings[c].standardError());
+      diff.push_back(result.difference[c].mean());
+      diffStderror.push_back(result.difference[c].standardError());
+    }
+    return std::make_tuple(mean, stderror, diff, diffStderror);
+}
+
 
 #if PYTHON
+  // NumPy front ends of the batch functions: the arrays are read and written in place and the GIL is released
+  // while the batch runs, so Python pays the call overhead once per batch instead of once per hand
+  using CardArray = pybind11::array_t<int32_t, pybind11::array::c_style | pybind11::array::forcecast>;
+
+  static void checkCardArray(const CardArray& cards, const char* name, const pybind11::ssize_t minCols, const pybind11::ssize_t maxCols) {
+    if( cards.ndim() != 2 or cards.shape(1) < minCols or cards.shape(1) > maxCols )
+      throw std::invalid_argument(std::string(name) + " must be an N x " + std::to_string(minCols) + ".." + std::to_string(maxCols) + " array of card codes");
+  }
+
+  pybind11::array_t<uint16_t> pyEvaluateHands(const CardArray& cards) {
+    checkCardArray(cards, "cards", 0, 7);
+    const pybind11::ssize_t n = cards.shape(0);
+    pybind11::array_t<uint16_t> strength(n);
+    const int32_t* in = cards.data();
+    uint16_t* out = strength.mutable_data();
+    {
+      pybind11::gil_scoped_release release;
+      evaluateHandsBatch(in, n, cards.shape(1), out);
+    }
+    return strength;
+  }
+
+  pybind11::array_t<int8_t> pyShowdownHandsBatch(const CardArray& cardsA, const CardArray& cardsB, const CardArray& commCards) {
+    checkCardArray(cardsA, "cardsA", 2, 2);
+    checkCardArray(cardsB, "cardsB", 2, 2);
+    checkCardArray(commCards, "commCards", 0, 5);
+    const pybind11::ssize_t n = cardsA.shape(0);
+    if( cardsB.shape(0) != n or commCards.shape(0) != n ) throw std::invalid_argument("cardsA, cardsB and commCards differ in length");
+    pybind11::array_t<int8_t> result(n);
+    const int32_t* a = cardsA.data();
+    const int32_t* b = cardsB.data();
+    const int32_t* board = commCards.data();
+    int8_t* out = result.mutable_data();
+    {
+      pybind11::gil_scoped_release release;
+      showdownHandsBatch(a, b, board, n, commCards.shape(1), out);
+    }
+    return result;
+  }
+
+  pybind11::array_t<double> pyEquityBatch(const CardArray& cards, const int numOtherPlayers, const uint64_t N) {
+    checkCardArray(cards, "cards", 2, 7);
+    const pybind11::ssize_t n = cards.shape(0);
+    pybind11::array_t<double> wtl({n, pybind11::ssize_t(3)});
+    const int32_t* in = cards.data();
+    double* out = wtl.mutable_data();
+    {
+      pybind11::gil_scoped_release release;
+      equityBatch(in, n, cards.shape(1), numOtherPlayers, N, out);
+    }
+    return wtl;
+  }
+
+  VecEnv pyVecEnv(const int numEnvs, const std::vector<std::string>& opponents, const int stack, const int smallBlind, const int bigBlind, const uint64_t seed) {
+    VecEnv::Settings settings;
+    settings.numEnvs = numEnvs;
+    settings.opponents = opponents;
+    settings.stack = stack;
+    settings.smallBlind = smallBlind;
+    settings.bigBlind = bigBlind;
+    settings.seed = seed;
+    return VecEnv(settings);
+  }
+
+  void pyVecEnvStep(VecEnv& env, const pybind11::array_t<int32_t, pybind11::array::c_style | pybind11::array::forcecast>& actions) {
+    if( actions.ndim() != 1 or actions.shape(0) != env.numEnvs() ) throw std::invalid_argument("actions must hold one action per table");
+    const int32_t* a = actions.data();
+    pybind11::gil_scoped_release release;
+    env.step(a);
+  }
+
+  template<typename T>
+  pybind11::array_t<T> vecEnvBuffer(pybind11::object self, T* data, const size_t columns) {
+    // A view of one of the environment's buffers: no copy, and it keeps the environment alive
+    const pybind11::ssize_t rows = self.cast<VecEnv&>().numEnvs();
+    if( columns == 0 ) return pybind11::array_t<T>({ rows }, data, self);
+    return pybind11::array_t<T>({ rows, pybind11::ssize_t(columns) }, data, self);
+  }
+
   /*
   PYBIND11_MODULE(poker, m) {
       m.def("MCGames", &pyMonteCarloRounds, "Monte Carlo Rounds",
@@ -188,10 +475,62 @@ double pyMonteCarloRounds(const uint64_t& N, std::vector<double> mattParams) {
   PYBIND11_MODULE(poker, m) {
       m.def("showdownHands", &pyShowdownHands, "showdown hands",
           pybind11::arg("cardsA"), pybind11::arg("cardsB"), pybind11::arg("commCards"));
+      m.def("encodeCards", &pyEncodeCards, "(rank, suit) pairs as card codes for the batch functions: 4 * (rank - 2) + suit - 1",
+          pybind11::arg("cards"));
+      m.def("evaluateHands", &pyEvaluateHands, "hand strength of every row of an N x k (k <= 7) array of card codes; larger is better, negative codes are skipped",
+          pybind11::arg("cards"));
+      m.def("showdownHandsBatch", &pyShowdownHandsBatch, "showdownHands for N x 2, N x 2 and N x k arrays of card codes: 0 if A won, 1 if B won, 2 if draw",
+          pybind11::arg("cardsA"), pybind11::arg("cardsB"), pybind11::arg("commCards"));
+      m.def("equityBatch", &pyEquityBatch, "N x 3 (win, tie, loss) against random hands for rows of hole cards then board, as card codes",
+          pybind11::arg("cards"), pybind11::arg("numOtherPlayers"), pybind11::arg("N"));
+      pybind11::class_<VecEnv>(m, "VecEnv")
+          .def(pybind11::init(&pyVecEnv), "numEnvs tables stepped in lockstep, the agent at seat 0 against the named opponent AIs",
+              pybind11::arg("numEnvs") = 16, pybind11::arg("opponents") = std::vector<std::string>{ "call" }, pybind11::arg("stack") = 100,
+              pybind11::arg("smallBlind") = 5, pybind11::arg("bigBlind") = 10, pybind11::arg("seed") = 1)
+          .def("reset", [](VecEnv& env) { pybind11::gil_scoped_release release; env.reset(); }, "deal a new hand at every table")
+          .def("step", &pyVecEnvStep, "one action (fold, call, raise, all-in = 0..3) per table; obs, mask, reward and done are updated in place",
+              pybind11::arg("actions"))
+          .def_property_readonly("obs", [](pybind11::object self) { return vecEnvBuffer(self, self.cast<VecEnv&>().observations(), VecEnv::kObservationSize); })
+          .def_property_readonly("mask", [](pybind11::object self) { return vecEnvBuffer(self, self.cast<VecEnv&>().masks(), VecEnv::kNumActions); })
+          .def_property_readonly("reward", [](pybind11::object self) { return vecEnvBuffer(self, self.cast<VecEnv&>().rewards(), 0); })
+          .def_property_readonly("done", [](pybind11::object self) { return vecEnvBuffer(self, self.cast<VecEnv&>().dones(), 0); })
+          .def_property_readonly("numEnvs", &VecEnv::numEnvs)
+          .def_property_readonly_static("observationSize", [](pybind11::object) { return VecEnv::kObservationSize; })
+          .def_property_readonly_static("numActions", [](pybind11::object) { return VecEnv::kNumActions; });
       m.def("MCSingleHand", &pyMCSingleHand, "monte carlo single hand",
           pybind11::arg("cards"), pybind11::arg("commCards"), pybind11::arg("numOtherPlayers"), pybind11::arg("N"));
+      m.def("equity", &pyEquity, "win/tie/loss against random hands, exact when there are at most N deals",
+          pybind11::arg("cards"), pybind11::arg("commCards"), pybind11::arg("numOtherPlayers"), pybind11::arg("N"));
+      m.def("equityToPrecision", &pyEquityToPrecision, "equity against random hands, sampled until it is known to within tolerance",
+          pybind11::arg("cards"), pybind11::arg("commCards"), pybind11::arg("numOtherPlayers"), pybind11::arg("tolerance"), pybind11::arg("maxSeconds") = 0.0);
       m.def("MCMattRounds", &pyMonteCarloRounds, "monte carlo rounds (matt)",
           pybind11::arg("N"), pybind11::arg("mattParams"));
+      m.def("MCMattDuplicateRounds", &pyMonteCarloDuplicateRounds, "duplicate-deal rounds (matt) for each threshold vector: (mean, stderr, diff vs first, diff stderr)",
+          pybind11::arg("N"), pybind11::arg("candidates"));
+      pybind11::class_<RegretRule>(m, "RegretRule")
+          .def(pybind11::init(&pyRegretRule), "regret update rule: variant is vanilla, cfr+, linear or dcfr",
+              pybind11::arg("variant") = "dcfr", pybind11::arg("alpha") = 1.5, pybind11::arg("beta") = 0.0, pybind11::arg("gamma") = 2.0,
+              pybind11::arg("pruneThreshold") = -std::numeric_limits<double>::infinity(), pybind11::arg("pruneAfter") = 0,
+              pybind11::arg("pruneProbability") = 0.95)
+          .def("strategy", &pyRegretStrategy, "regret matching", pybind11::arg("regretSum"))
+          .def("accumulate", &pyRegretAccumulate, "add one iteration's regrets", pybind11::arg("regretSum"), pybind11::arg("regrets"))
+          .def("discount", &pyRegretDiscount, "discount regret and strategy sums after an iteration",
+              pybind11::arg("regretSum"), pybind11::arg("strategySum"), pybind11::arg("iteration"))
+          .def("prunable", &pyRegretPrunable, "actions whose regret is below the pruning threshold", pybind11::arg("regretSum"));
+      m.def("trainCFR", &pyTrainCFR, "train a heads-up CFRAI1 policy with external-sampling MCCFR and write it to outfile",
+          pybind11::arg("iterations"), pybind11::arg("outfile"), pybind11::arg("stack") = 100,
+          pybind11::arg("smallBlind") = 5, pybind11::arg("bigBlind") = 10, pybind11::arg("rule") = RegretRule(),
+          pybind11::arg("bucketfile") = "");
+      m.def("exploitability", &pyExploitability, "mbb/hand a best response wins against the heads-up CFRAI1 policy in policyfile, over a sampled set of boards",
+          pybind11::arg("policyfile"), pybind11::arg("stack") = 100, pybind11::arg("smallBlind") = 5, pybind11::arg("bigBlind") = 10,
+          pybind11::arg("flops") = 16, pybind11::arg("turnsPerFlop") = 2, pybind11::arg("riversPerTurn") = 2, pybind11::arg("seed") = 1,
+          pybind11::arg("bucketfile") = "");
+      m.def("buildHandBuckets", &pyBuildHandBuckets, "cluster hands by equity distribution into a card abstraction file for trainCFR (bucketfile)",
+          pybind11::arg("outfile"), pybind11::arg("buckets") = std::array<int, HandBuckets::kNumStreets>{169, 64, 64, 64},
+          pybind11::arg("feature") = "histogram", pybind11::arg("metric") = "emd", pybind11::arg("histogramBins") = 32,
+          pybind11::arg("runouts") = 64, pybind11::arg("trainingBoards") = 64, pybind11::arg("iterations") = 25, pybind11::arg("seed") = 1);
+      m.def("setSeed", &setMasterSeed, "seed every random stream created afterwards",
+          pybind11::arg("seed"));
   }
 
 #endif
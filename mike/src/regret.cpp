@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "regret.h"
+
+namespace Poker {
+
+  CFRVariant parseCFRVariant(const std::string& name) {
+      if( name == "vanilla" ) return CFRVariant::Vanilla;
+      if( name == "cfr+" or name == "cfrplus" ) return CFRVariant::CFRPlus;
+      if( name == "linear" ) return CFRVariant::Linear;
+      if( name == "dcfr" or name == "discounted" ) return CFRVariant::Discounted;
+      throw std::invalid_argument("unknown CFR variant " + name);
+  }
+
+  RegretRule::Discount RegretRule::discountAfter(const uint64_t iteration) const {
+      Discount d;
+      const double t = static_cast<double>(iteration);
+      switch( variant ) {
+          case CFRVariant::Vanilla:
+              break;
+          case CFRVariant::CFRPlus:
+              d.strategy = t / (t + 1.0);
+              break;
+          case CFRVariant::Linear:
+              d.positive = d.negative = d.strategy = t / (t + 1.0);
+              break;
+          case CFRVariant::Discounted: {
+              const double ta = std::pow(t, alpha), tb = std::pow(t, beta);
+              d.positive = ta / (ta + 1.0);
+              d.negative = tb / (tb + 1.0);
+              d.strategy = std::pow(t / (t + 1.0), gamma);
+              break;
+          }
+      }
+      return d;
+  }
+
+  void RegretRule::regretMatching(const float* regrets, const bool* legal, const int n, float* strategy) {
+      float sum = 0.0f;
+      int numLegal = 0;
+      for(int a = 0; a < n; a++) {
+          const bool ok = !legal or legal[a];
+          strategy[a] = ok ? std::max(0.0f, regrets[a]) : 0.0f;
+          sum += strategy[a];
+          numLegal += ok;
+      }
+      for(int a = 0; a < n; a++) {
+          const bool ok = !legal or legal[a];
+          strategy[a] = sum > 0.0f ? strategy[a] / sum : ok ? 1.0f / numLegal : 0.0f;
+      }
+  }
+
+}
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include "rng.h"
+
+namespace Poker {
+  namespace {
+    struct MasterStreams {
+        std::mutex lock;
+        uint64_t seed;
+        Rng source;
+        std::atomic<uint64_t> generation { 0 };      // bumped on reseed so threadRng() picks up a new stream
+
+        MasterStreams() {
+            if( const char* env = std::getenv("POKER_SEED") ) {
+                seed = std::strtoull(env, nullptr, 0);
+            } else {
+                // the only entropy syscall of the run
+                std::random_device rd;
+                seed = (uint64_t(rd()) << 32) ^ rd();
+            }
+            source.seed(seed);
+        }
+    };
+
+    MasterStreams& master() {
+        static MasterStreams m;
+        return m;
+    }
+  }
+
+  void setMasterSeed(uint64_t seed) {
+      MasterStreams& m = master();
+      std::lock_guard<std::mutex> guard(m.lock);
+      m.seed = seed;
+      m.source.seed(seed);
+      m.generation++;
+  }
+
+  uint64_t getMasterSeed() {
+      MasterStreams& m = master();
+      std::lock_guard<std::mutex> guard(m.lock);
+      return m.seed;
+  }
+
+  Rng newRngStream() {
+      MasterStreams& m = master();
+      std::lock_guard<std::mutex> guard(m.lock);
+      return m.source.split();
+  }
+
+  Rng& threadRng() {
+      thread_local Rng rng;
+      thread_local uint64_t generation = UINT64_MAX;
+      const uint64_t current = master().generation.load(std::memory_order_relaxed);
+      if( generation != current ) {
+          rng = newRngStream();
+          generation = current;
+      }
+      return rng;
+  }
+
+}
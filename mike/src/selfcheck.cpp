@@ -0,0 +1,177 @@
+#include <algorithm>
+#include "selfcheck.h"
+#include "evaluator.h"
+#include "isomorphism.h"
+#include "rng.h"
+
+namespace Poker {
+  namespace {
+    constexpr int kNumCards = 52;
+
+    uint32_t naiveFiveCardKey(const int cards[5]) {
+        // The FullHandRank value of exactly five card indices, worked out the long way: group the ranks by count,
+        // then look for flushes and straights
+        int counts[13] = {};
+        bool flush = true;
+        for(int i = 0; i < 5; i++) {
+            counts[cards[i] & 15]++;
+            flush = flush and (cards[i] >> 4) == (cards[0] >> 4);
+        }
+        // (count, rank) pairs, biggest group first and higher ranks first within a count
+        int groups[5][2];
+        int numGroups = 0;
+        for(int c = 4; c >= 1; c--)
+            for(int r = 12; r >= 0; r--)
+                if( counts[r] == c ) {
+                    groups[numGroups][0] = c;
+                    groups[numGroups++][1] = r;
+                }
+        int straight = -1;
+        if( numGroups == 5 ) {
+            if( groups[0][1] - groups[4][1] == 4 ) straight = groups[0][1];
+            else if( groups[0][1] == 12 and groups[1][1] == 3 ) straight = 3;      // the wheel, five high
+        }
+
+        HandRank category;
+        int numRanks = numGroups;
+        if( straight >= 0 and flush ) category = HandRank::STRAIGHT_FLUSH;
+        else if( groups[0][0] == 4 ) category = HandRank::FOUR_KIND;
+        else if( groups[0][0] == 3 and groups[1][0] == 2 ) category = HandRank::FULL_HOUSE;
+        else if( flush ) category = HandRank::FLUSH;
+        else if( straight >= 0 ) category = HandRank::STRAIGHT;
+        else if( groups[0][0] == 3 ) category = HandRank::THREE_KIND;
+        else if( groups[0][0] == 2 and groups[1][0] == 2 ) category = HandRank::TWO_PAIR;
+        else if( groups[0][0] == 2 ) category = HandRank::ONE_PAIR;
+        else category = HandRank::HIGH_CARD;
+        if( straight >= 0 ) {
+            groups[0][1] = straight;
+            numRanks = 1;
+        }
+
+        uint32_t key = static_cast<uint32_t>(category) << 20;
+        for(int i = 0; i < numRanks; i++) key |= static_cast<uint32_t>(groups[i][1] + 1) << (16 - 4 * i);
+        return key;
+    }
+
+    uint32_t naiveBestKey(const CardSet& hand) {
+        // Best five of five to seven cards
+        int cards[7];
+        int n = 0;
+        hand.forEachIndex([&cards, &n](int i) { cards[n++] = i; });
+        uint32_t best = 0;
+        int pick[5];
+        for(int a = 0; a < n; a++)
+            for(int b = a + 1; b < n; b++)
+                for(int c = b + 1; c < n; c++)
+                    for(int d = c + 1; d < n; d++)
+                        for(int e = d + 1; e < n; e++) {
+                            pick[0] = cards[a]; pick[1] = cards[b]; pick[2] = cards[c]; pick[3] = cards[d]; pick[4] = cards[e];
+                            best = std::max(best, naiveFiveCardKey(pick));
+                        }
+        return best;
+    }
+
+    CardSet permuteSuits(const CardSet& cards, const int perm[4]) {
+        CardSet out;
+        cards.forEachIndex([&out, perm](int i) { out.insertIndex(16 * perm[i >> 4] + (i & 15)); });
+        return out;
+    }
+
+    bool roundTrip(const HandIndexer& indexer, const uint64_t idx, const int street, std::ostream& out) {
+        // unindex must give a hand of the right shape that indexes back to idx
+        CardSet rounds[2];
+        indexer.unindex(idx, rounds);
+        const bool valid = rounds[0].size() == 2 and rounds[1].size() == size_t(street == 0 ? 0 : street + 2)
+                           and !rounds[0].intersects(rounds[1]) and CardSet::fullDeck().contains(rounds[0] | rounds[1]);
+        if( valid and indexer.index(rounds) == idx ) return true;
+        out << "street " << street << " index " << idx << " unindexes to " << rounds[0] << "| " << rounds[1] << std::endl;
+        return false;
+    }
+  }
+
+  bool selfCheckEvaluator(std::ostream& out, const uint64_t numSevenCardHands) {
+      // Every 5-card hand, with the number of hands in each category as the textbooks count them
+      static const uint64_t kCategoryCounts[10] = { 0, 1302540, 1098240, 123552, 54912, 10200, 5108, 3744, 624, 40 };
+      uint64_t categoryCounts[10] = {};
+      int deck[kNumCards];
+      int n = 0;
+      CardSet::fullDeck().forEachIndex([&deck, &n](int i) { deck[n++] = i; });
+      int pick[5];
+      for(pick[0] = 0; pick[0] < kNumCards; pick[0]++)
+      for(pick[1] = pick[0] + 1; pick[1] < kNumCards; pick[1]++)
+      for(pick[2] = pick[1] + 1; pick[2] < kNumCards; pick[2]++)
+      for(pick[3] = pick[2] + 1; pick[3] < kNumCards; pick[3]++)
+      for(pick[4] = pick[3] + 1; pick[4] < kNumCards; pick[4]++) {
+          int cards[5];
+          CardSet hand;
+          for(int i = 0; i < 5; i++) {
+              cards[i] = deck[pick[i]];
+              hand.insertIndex(cards[i]);
+          }
+          const FullHandRank fhr = decodeHandStrength(evaluateHand(hand));
+          if( fhr.value != naiveFiveCardKey(cards) ) {
+              out << "evaluator: " << hand << "is " << fhr << "but should be " << FullHandRank(naiveFiveCardKey(cards)) << std::endl;
+              return false;
+          }
+          categoryCounts[static_cast<int>(fhr.handrank())]++;
+      }
+      if( !std::equal(categoryCounts, categoryCounts + 10, kCategoryCounts) ) {
+          out << "evaluator: wrong number of 5-card hands in some category" << std::endl;
+          return false;
+      }
+      out << "evaluator: all 2598960 5-card hands match" << std::endl;
+
+      // Random 7-card hands against the best of their 21 five-card hands; strengths must order like the hands
+      Rng rng(1);
+      Deck sevenDeck;
+      HandStrength lastStrength = 0;
+      uint32_t lastKey = 0;
+      for(uint64_t h = 0; h < numSevenCardHands; h++) {
+          sevenDeck.reset();
+          const CardSet hand = sevenDeck.pop_cards(rng, 7);
+          const HandStrength strength = evaluateHand(hand);
+          const uint32_t key = naiveBestKey(hand);
+          if( decodeHandStrength(strength).value != key or (strength < lastStrength) != (key < lastKey) or (strength == lastStrength) != (key == lastKey) ) {
+              out << "evaluator: " << hand << "is " << decodeHandStrength(strength) << "but should be " << FullHandRank(key) << std::endl;
+              return false;
+          }
+          lastStrength = strength;
+          lastKey = key;
+      }
+      out << "evaluator: " << numSevenCardHands << " random 7-card hands match the best of their 5-card hands" << std::endl;
+      return true;
+  }
+
+  bool selfCheckHandIndexer(std::ostream& out, const uint64_t numSamples) {
+      // Preflop and flop round trip for every class; the turn and river, with too many to go through, on random
+      // indices, and random hands must index in range and ignore a renaming of the suits
+      Rng rng(2);
+      for(int street = 0; street < 4; street++) {
+          const HandIndexer& indexer = HandIndexer::forStreet(street);
+          if( street < 2 ) {
+              for(uint64_t idx = 0; idx < indexer.size(); idx++)
+                  if( !roundTrip(indexer, idx, street, out) ) return false;
+          }
+          else {
+              for(uint64_t s = 0; s < numSamples; s++)
+                  if( !roundTrip(indexer, rng() % indexer.size(), street, out) ) return false;
+          }
+
+          Deck deck;
+          int perm[4] = { 0, 1, 2, 3 };
+          for(uint64_t s = 0; s < numSamples; s++) {
+              deck.reset();
+              const CardSet hole = deck.pop_cards(rng, 2);
+              const CardSet board = deck.pop_cards(rng, street == 0 ? 0 : street + 2);
+              std::shuffle(perm, perm + 4, rng);
+              const uint64_t idx = indexer.index(hole, board);
+              if( idx >= indexer.size() or indexer.index(permuteSuits(hole, perm), permuteSuits(board, perm)) != idx ) {
+                  out << "indexer: street " << street << " hand " << hole << "| " << board << "indexes inconsistently" << std::endl;
+                  return false;
+              }
+          }
+          out << "indexer: street " << street << " (" << indexer.size() << " classes) round trips and is suit invariant" << std::endl;
+      }
+      return true;
+  }
+}
@@ -1,43 +1,46 @@
 #include "strategy.h"
+#include "tableview.h"
 #include "player.h"
+#include "equity.h"
+#include "preflop.h"
 #include <string>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <stdexcept>
 namespace Poker {
     
-    PlayerMove Strategy::makeMove(std::shared_ptr<Table> info, const shared_ptr<Player> p) {
+    PlayerMove Strategy::makeMove(const TableView& info) {
+        const Player& p = info.self();
         // Default behavior: Always call
-        // p = contains last move info
         auto clamp = [](int a, int b, int c) -> int { if(a<b) a=b; if(a>c) a=c; return a;};
         PlayerMove myMove;
         myMove.move = Move::MOVE_CALL;
-        myMove.bet_amount = info->minimumBet;
-        myMove.bet_amount = clamp(myMove.bet_amount, 0, p->bankroll);
-        if( myMove.bet_amount == p->bankroll) myMove.move = Move::MOVE_ALLIN;
+        myMove.bet_amount = info.minimumBet();
+        myMove.bet_amount = clamp(myMove.bet_amount, 0, p.bankroll);
+        if( myMove.bet_amount == p.bankroll) myMove.move = Move::MOVE_ALLIN;
         return myMove;
     }   
 
-    PlayerMove SingleMoveCallAI::makeMove(std::shared_ptr<Table> info, const shared_ptr<Player> p) {
+    PlayerMove SingleMoveCallAI::makeMove(const TableView& info) {
+        const Player& p = info.self();
         auto clamp = [](int a, int b, int c) -> int { if(a<b) a=b; if(a>c) a=c; return a;};
         
         PlayerMove myMove;
         myMove.move = Move::MOVE_CALL;
-        myMove.bet_amount = info->minimumBet;
-        myMove.bet_amount = clamp(myMove.bet_amount, 0, p->bankroll);
-        if( myMove.bet_amount == p->bankroll) myMove.move = Move::MOVE_ALLIN;
+        myMove.bet_amount = info.minimumBet();
+        myMove.bet_amount = clamp(myMove.bet_amount, 0, p.bankroll);
+        if( myMove.bet_amount == p.bankroll) myMove.move = Move::MOVE_ALLIN;
         return myMove;
     }   
     
-    PlayerMove RandomAI::makeMove(std::shared_ptr<Table> info, const shared_ptr<Player> p) {
+    PlayerMove RandomAI::makeMove(const TableView& info) {
+        const Player& p = info.self();
 
         // Performs a random valid move
         auto clamp = [](int a, int b, int c) -> int { if(a<b) a=b; if(a>c) a=c; return a;};
-        std::random_device dev;
-        std::mt19937 rng(dev());
-        std::uniform_int_distribution<std::mt19937::result_type> dist4(1,4);
         PlayerMove myMove;
-        switch( dist4(rng) ) {
+        switch( boundedRandom(rng, 4) + 1 ) {
             case 1:
                 myMove.move = Move::MOVE_FOLD;
                 break;
@@ -51,14 +54,15 @@ namespace Poker {
                 myMove.move = Move::MOVE_ALLIN;
         }
         if( myMove.move == Move::MOVE_FOLD) myMove.bet_amount = 0;
-        else if( myMove.move == Move::MOVE_CALL) myMove.bet_amount = info->minimumBet;
-        else if( myMove.move == Move::MOVE_RAISE) myMove.bet_amount = info->minimumBet * 2;
-        else if( myMove.move == Move::MOVE_ALLIN) myMove.bet_amount = p->bankroll;
-        myMove.bet_amount = clamp(myMove.bet_amount, 0, p->bankroll);
-        if( myMove.bet_amount == p->bankroll) myMove.move = Move::MOVE_ALLIN;
+        else if( myMove.move == Move::MOVE_CALL) myMove.bet_amount = info.minimumBet();
+        else if( myMove.move == Move::MOVE_RAISE) myMove.bet_amount = info.minimumBet() * 2;
+        else if( myMove.move == Move::MOVE_ALLIN) myMove.bet_amount = p.bankroll;
+        myMove.bet_amount = clamp(myMove.bet_amount, 0, p.bankroll);
+        if( myMove.bet_amount == p.bankroll) myMove.move = Move::MOVE_ALLIN;
         return myMove;
     }
-    PlayerMove SequenceMoveAI::makeMove(std::shared_ptr<Table> info, const shared_ptr<Player> p) {
+    PlayerMove SequenceMoveAI::makeMove(const TableView& info) {
+        const Player& p = info.self();
         // Performs a list of moves
         // If it reaches the end of its move sequence, repeats the last one
         auto clamp = [](int a, int b, int c) -> int { if(a<b) a=b; if(a>c) a=c; return a;};
@@ -68,74 +72,84 @@ namespace Poker {
             index++;
         // sanitize the move... unnecessary?
         if( myMove.move == Move::MOVE_FOLD) myMove.bet_amount = 0;
-        if( myMove.move == Move::MOVE_CALL) myMove.bet_amount = info->minimumBet;
-        if( myMove.move == Move::MOVE_ALLIN) myMove.bet_amount = p->bankroll;
-        myMove.bet_amount = clamp(myMove.bet_amount, 0, p->bankroll);
-        if( myMove.bet_amount == p->bankroll) myMove.move = Move::MOVE_ALLIN;
+        if( myMove.move == Move::MOVE_CALL) myMove.bet_amount = info.minimumBet();
+        if( myMove.move == Move::MOVE_ALLIN) myMove.bet_amount = p.bankroll;
+        myMove.bet_amount = clamp(myMove.bet_amount, 0, p.bankroll);
+        if( myMove.bet_amount == p.bankroll) myMove.move = Move::MOVE_ALLIN;
         return myMove;
     }
     
 
-    PlayerMove MoveAwareAI::makeMove(shared_ptr<Table> info, const shared_ptr<Player> p) {
+    static PlayerMove betAmountToMove(int betAmount, const TableView& info) {
+      const Player& p = info.self();
+      PlayerMove myMove;
+      myMove.bet_amount = betAmount;
+      clamp(myMove.bet_amount, 0, p.bankroll);
+      if( myMove.bet_amount == 0 ) myMove.move = Move::MOVE_FOLD;
+      else if( myMove.bet_amount == p.bankroll ) myMove.move = Move::MOVE_ALLIN;
+      else {
+        clamp(myMove.bet_amount, info.minimumBet(), p.bankroll);
+        if( myMove.bet_amount > info.minimumBet() )
+          myMove.move = Move::MOVE_RAISE;
+        else
+          myMove.move = Move::MOVE_CALL;
+      }
+      return myMove;
+    }
+
+    PlayerMove MoveAwareAI::makeMove(const TableView& info) {
+      const Player& p = info.self();
       // Set me to playerID = 0
-      auto otherGuy = info->getPlayerByID(1);
-      if( info->street == 0) enemyMoves.clear();
-      if( otherGuy->getPosition() < p->getPosition()) {
+      auto otherGuy = info.seatByID(1);
+      if( info.street() == 0) enemyMoves.clear();
+      if( otherGuy.position < p.getPosition()) {
         // other guy already made a move
-        enemyMoves.emplace_back(otherGuy->move.move);
+        enemyMoves.emplace_back(otherGuy.move.move);
       }
       while( enemyMoves.size() > 2) { enemyMoves.erase(enemyMoves.begin()); } //trim to last two moves
-      auto myMove = betAmountToMove(  moveSequenceToBet[enemyMoves], info, p);
+      auto myMove = betAmountToMove(  moveSequenceToBet[enemyMoves], info);
       return myMove;
     }
 
-    PlayerMove CFRAI1::makeMove(shared_ptr<Table> info, const shared_ptr<Player> p) {
-      // Add this game state to the table if it doesn't exist
-      ReducedGameState myRGS = packTableIntoReducedGameState(*info);
-      PlayerMove myPMove;
-
-      map<BinnedPlayerMove, float> probMap;
-      std::random_device rd;
-      std::mt19937_64 gen(rd());
-
-      float tot = 0.0f;
-
-      auto [updatedIter, rgsWasNew] = CFRTable.try_emplace(myRGS);
-      // rgsWasNew is true is the RGS key didn't exist in the CFR table
-      // updatedIter is an iterator to the key corresponding to the game state whether or not the insertion took place
-      if( rgsWasNew ) {
-        // make a random move if we don't have a policy
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-        probMap[BinnedPlayerMove::AllIn] = dist(gen);
-        probMap[BinnedPlayerMove::Raise] = dist(gen);
-        probMap[BinnedPlayerMove::Call] = dist(gen);
-        probMap[BinnedPlayerMove::Fold] = dist(gen);
-        for_each(probMap.begin(), probMap.end(), [&tot](const pair<BinnedPlayerMove, float> pair) { 
-          tot += pair.second;
-        });
-        // insert the normalized random policy
-        CFRTable[myRGS] = probMap;
+    PlayerMove CFRAI1::makeMove(const TableView& info) {
+      const Player& p = info.self();
+      const InfosetKey key = packTableIntoReducedGameState(info).key();
+      float probs[kNumBinnedMoves];
+      const StrategyFile::Entry* entry = policyFile ? policyFile->find(key) : nullptr;
+      if( entry ) {
+        std::copy(entry->values, entry->values + kNumBinnedMoves, probs);
       }
       else {
-        // policy is already in there
-        probMap = CFRTable[myRGS];
+        // Add this game state to the table if it doesn't exist
+        if( CFRTable.needsGrowth() ) CFRTable.grow();
+        auto [slot, rgsWasNew] = CFRTable.findOrInsert(key);
+        if( rgsWasNew ) {
+          // make a random move if we don't have a policy
+          std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+          for(auto& v : slot->values) v.store(dist(rng), std::memory_order_relaxed);
+        }
+        for(int a = 0; a < kNumBinnedMoves; a++) probs[a] = slot->values[a].load(std::memory_order_relaxed);
       }
 
-      // Sample the choices according to the prob dist
-      std::uniform_real_distribution<float> dist(0.0f, tot);
-      float choice = dist(gen);
-      float partialSum = 0.0f;
-      BinnedPlayerMove bpm;
-      vector<float> cumProbs(probMap.size());
-      for( auto& pair : probMap ) {
-        partialSum += pair.second;
-        if(partialSum >= choice) {
-          bpm = pair.first;
-          break;
-        } 
+      // Sample the choices according to the weights
+      float tot = 0.0f;
+      for(int a = 0; a < kNumBinnedMoves; a++) {
+        probs[a] = std::max(0.0f, probs[a]);
+        tot += probs[a];
+      }
+      BinnedPlayerMove bpm = BinnedPlayerMove::Call;
+      if( tot > 0.0f ) {
+        std::uniform_real_distribution<float> dist(0.0f, tot);
+        const float choice = dist(rng);
+        float partialSum = 0.0f;
+        for(int a = 0; a < kNumBinnedMoves; a++) {
+          partialSum += probs[a];
+          bpm = static_cast<BinnedPlayerMove>(a);
+          if( probs[a] > 0.0f and partialSum >= choice ) break;
+        }
       }
 
-      return unpackBinnedPlayerMove(bpm, info->minimumBet, p->bankroll);
+      return unpackBinnedPlayerMove(bpm, info.minimumBet(), p.bankroll);
     }
 
     CFRAI1::BinnedPlayerMove CFRAI1::packBinnedPlayerMove(PlayerMove m) {
@@ -146,25 +160,70 @@ namespace Poker {
       else return CFRAI1::BinnedPlayerMove::Undef;
     }
 
-    CFRAI1::ReducedGameState CFRAI1::packTableIntoReducedGameState(Table table) {
+    CFRAI1::ReducedGameState CFRAI1::packTableIntoReducedGameState(const TableView& view) {
         ReducedGameState rgs;
-        rgs.street = table.street;
-        // Player 0 is the special player
-        shared_ptr<Player> playerZero = table.getPlayerByID(0);
-        rgs.position = playerZero->getPosition();
+        const Player& player = view.self();
+        rgs.street = view.street();
+        rgs.position = player.getPosition();
 
         // This could probably be moved to dealCommunityCards
-        vector<Card> pHand = playerZero->hand;
-        vector<Card> allCards = table.communityCards;
-        allCards.insert(allCards.begin(), pHand.begin(), pHand.end());
-        FullHandRank myFHR = calcFullHandRank(allCards);
-        rgs.RFHR.handrank = myFHR.handrank;
-        rgs.RFHR.maincard = *min(myFHR.maincards.begin(), myFHR.maincards.end()); // min actually returns the max rank very cool
-        for( auto& p : table.playerList ) {
-          rgs.playerHistory[p->getPosition()].push_back(packBinnedPlayerMove(p->move));
+        const FullHandRank myFHR = calcFullHandRank(player.hand | view.communityCards());
+        rgs.RFHR.handrank = myFHR.handrank();
+        rgs.RFHR.maincard = Card(myFHR.mainRank(0), Suit::UNDEF_SUIT);   // only the rank is part of the state
+        if( handBuckets )
+          rgs.handClass = handBuckets->bucket(player.hand, view.communityCards());      // stays -1 on streets it doesn't cover
+        rgs.lastMove.fill(BinnedPlayerMove::Undef);
+        view.forEachSeat([this, &rgs](const TableView::Seat& seat) {
+          const int pos = static_cast<int>(seat.position);
+          rgs.lastMove[pos] = packBinnedPlayerMove(seat.move);
+          rgs.seated |= 1u << pos;
+        });
+        return rgs;
+    }
+
+    int CFRAI1::handClassOf(const ReducedFullHandRank& r) {
+        return static_cast<int>(r.handrank) * 14 + r.maincard.get_rank_as_int() + 1;
+    }
+
+    int CFRAI1::handClassOf(const CardSet& hole, const CardSet& board, const HandBuckets* buckets) {
+        if( buckets ) {
+          const int b = buckets->bucket(hole, board);
+          if( b >= 0 ) return b;
+        }
+        const FullHandRank fhr = calcFullHandRank(hole | board);
+        ReducedFullHandRank r;
+        r.handrank = fhr.handrank();
+        r.maincard = Card(fhr.mainRank(0), Suit::UNDEF_SUIT);
+        return handClassOf(r);
+    }
+
+    CFRAI1::InfosetKey CFRAI1::ReducedGameState::key() const {
+        const InfosetKey cls = handClass >= 0 ? handClass : handClassOf(RFHR);
+        InfosetKey k = static_cast<InfosetKey>(position) | static_cast<InfosetKey>(street) << 4 | cls << 7;
+        for(int pos = 0; pos < kNumPositions; pos++) {
+          if( seated & (1u << pos) )
+            k |= static_cast<InfosetKey>(static_cast<int>(lastMove[pos]) + 2) << (15 + 3 * pos);
+        }
+        return k;
+    }
+
+    CFRAI1::ReducedGameState CFRAI1::ReducedGameState::fromKey(const InfosetKey key) {
+        ReducedGameState rgs;
+        rgs.position = static_cast<PlayerPosition>(key & 0xf);
+        rgs.street = (key >> 4) & 0x7;
+        const int handClass = (key >> 7) & 0xff;
+        rgs.RFHR.handrank = static_cast<HandRank>(handClass / 14);
+        rgs.RFHR.maincard = Card(static_cast<Rank>(handClass % 14 - 1), Suit::UNDEF_SUIT);
+        rgs.lastMove.fill(BinnedPlayerMove::Undef);
+        for(int pos = 0; pos < kNumPositions; pos++) {
+          const int m = (key >> (15 + 3 * pos)) & 0x7;
+          if( m == 0 ) continue;
+          rgs.lastMove[pos] = static_cast<BinnedPlayerMove>(m - 2);
+          rgs.seated |= 1u << pos;
         }
         return rgs;
     }
+
     PlayerMove CFRAI1::unpackBinnedPlayerMove(BinnedPlayerMove m, int minimumBet, int bankroll) {
       PlayerMove ret;
       if(m == CFRAI1::BinnedPlayerMove::AllIn ) {
@@ -187,127 +246,49 @@ namespace Poker {
     }
     
     void CFRAI1::dumpCFRTableToFile(std::string outfile) {
-      std::ofstream outFile(outfile, std::ios_base::app);
-      if( !outFile ) throw;
-
-      // Transform a reduced game state to a string
-      std::ostringstream oss;
-      auto RGSintoStream = [&oss] (ReducedGameState rgs) {
-          oss << static_cast<int>(rgs.position) << "," << rgs.street << ",";
-          oss << static_cast<int>(rgs.RFHR.handrank) << "," << static_cast<int>(rgs.RFHR.maincard.get_rank()) << ",";
-          for(const auto& pair : rgs.playerHistory) {
-            auto pos = pair.first;
-            std::vector<BinnedPlayerMove> moves = pair.second;
-            oss << static_cast<int>(pos) << "," << moves.size() << ",";
-            for(int i=0; i<moves.size(); i++) {
-              oss << static_cast<int>(moves[i]) << ",";
-            }
-          }
-      };
-      
-      // Print RGS and probabilities on one line
-      for(const auto& pair : CFRTable) {
-        RGSintoStream(pair.first);
-        auto BPMprobmap = pair.second;
-        for(auto it = BPMprobmap.begin(); it != BPMprobmap.end(); it++) {
-          // print probabilities
-          oss << it->second; 
-          if(std::distance(it, BPMprobmap.end()) == 1) oss << std::endl;
-          else oss << ",";
-        }
-        outFile << oss.str();
-      }
-      outFile.close();
+      if( !StrategyFile::write(outfile, CFRTable, HandBuckets::fingerprint(handBuckets.get())) ) throw std::runtime_error("CFRAI1: can't write " + outfile);
     }
     void CFRAI1::loadCFRTableFromFile(std::string infile) {
-      std::ifstream inFile(infile);
-      if( !inFile ) throw;
-      unordered_map<ReducedGameState, map<BinnedPlayerMove, float>, RGSHash> tableIn;
-      std::vector<std::vector<std::string>> data;
-      std::string line;
-      while(std::getline(inFile, line)) {
-        std::vector<std::string> row;
-        std::stringstream ss(line);
-        std::string field;
-        while (std::getline(ss, field, ',')) {
-          row.push_back(field);
-        }
-        data.push_back(row);
-      }
-
-      for(auto& row : data) {
-        // key
-        ReducedGameState rgs;
-        rgs.position = static_cast<PlayerPosition>(std::stoi(row[0]));
-        rgs.street =          std::stoi(row[1]);
-        rgs.RFHR.handrank = static_cast<HandRank>(std::stoi(row[2]));
-        Card main;
-        main.rank = static_cast<Rank>(std::stoi(row[3]));
-        rgs.RFHR.maincard = main;
-        
-        unordered_map<PlayerPosition, vector<BinnedPlayerMove>, PlayerPositionHash> pHistory;
-        size_t ind = 4;
-        size_t runningInd = 0;
-        while(typeid(row[ind]) != typeid(float)) {
-          PlayerPosition pp = static_cast<PlayerPosition>(std::stoi(row[ind]));
-          size_t bpmv_ld = std::stoi(row[ind+1]);
-          vector<BinnedPlayerMove> bpmv;
-          for(int j=0; j < bpmv_ld; j++){
-            bpmv.emplace_back(static_cast<BinnedPlayerMove>(std::stoi(row[ind+2+j])));
-          }
-          ind += 2 + bpmv_ld;
-          pHistory[pp] = bpmv;
-        }
-        rgs.playerHistory = pHistory;
-
-        vector<float> probs;
-        for(size_t j=0; j < 4; j++) {   // CHANGE THIS is the number of BinnedPlayerMoves increases!
-          probs[j] = std::stof(row[ind+j]);
-        }
-
-        map<BinnedPlayerMove, float> probMap;
-        probMap[BinnedPlayerMove::Fold] = probs[0];
-        probMap[BinnedPlayerMove::Call] = probs[1];
-        probMap[BinnedPlayerMove::Raise] = probs[2];
-        probMap[BinnedPlayerMove::AllIn] = probs[3];
-
-        tableIn[rgs] = probMap;
-      }
-
-      inFile.close();
-      CFRTable = tableIn;
+      auto file = std::make_shared<StrategyFile>();
+      if( !file->open(infile) ) throw std::runtime_error("CFRAI1: " + infile + " is missing or not a valid strategy file");
+      if( file->bucketFingerprint() != HandBuckets::fingerprint(handBuckets.get()) )
+        throw std::runtime_error("CFRAI1: " + infile + " was trained with other hand buckets than this AI's; load them first");
+      policyFile = file;
+    }
 
+    void CFRAI1::loadHandBucketsFromFile(std::string infile) {
+      auto buckets = std::make_shared<HandBuckets>();
+      if( !buckets->load(infile) ) throw std::runtime_error("CFRAI1: " + infile + " is missing or not a valid hand bucket file");
+      if( policyFile and policyFile->bucketFingerprint() != HandBuckets::fingerprint(buckets.get()) )
+        throw std::runtime_error("CFRAI1: " + infile + " are not the hand buckets the loaded policy was trained with");
+      handBuckets = buckets;
     }
 
 
 
 
 
-    static PlayerMove betAmountToMove(int betAmount, shared_ptr<Table>& info, const shared_ptr<Player>& p) {
-      PlayerMove myMove;
-      myMove.bet_amount = betAmount;
-      clamp(myMove.bet_amount, 0, p->bankroll);
-      if( myMove.bet_amount == 0 ) myMove.move = Move::MOVE_FOLD;
-      else if( myMove.bet_amount == p->bankroll ) myMove.move = Move::MOVE_ALLIN;
-      else {
-        clamp(myMove.bet_amount, info->minimumBet, p->bankroll);
-        if( myMove.bet_amount > info->minimumBet )
-          myMove.move = Move::MOVE_RAISE;
-        else
-          myMove.move = Move::MOVE_CALL;
-      }
-      return myMove;
-
-    }
 
 
-    PlayerMove MattAI::makeMove(std::shared_ptr<Table> info, const shared_ptr<Player> p) {
-      int numOtherPlayers = info->playerList.size() - 1;
+    PlayerMove MattAI::makeMove(const TableView& info) {
+      const Player& p = info.self();
+      int numOtherPlayers = info.numSeats() - 1;
       const double foldCallThres = thresholds[0];
       const double callRaiseThres = thresholds[1];
       const double raiseAllinThres = thresholds[2];
-      auto [avg, sigma] = monteCarloSingleHand(p->hand, info->communityCards, numOtherPlayers, 100);
-      //std::cout << "MATT SAYS: " << p->hand << " = " << matt << std::endl;
+      // share of the pot this hand expects at showdown against random hands
+      double avg;
+      const PreflopTable* preflop = preflopTable();
+      if( info.street() == 0 and preflop and preflop->covers(numOtherPlayers) and preflopClass(p.hand) >= 0 ) {
+        avg = preflop->equity(p.hand, numOtherPlayers);
+      } else {
+        PrecisionTarget target;
+        target.tolerance = equityTolerance;
+        target.thresholds = thresholds;
+        target.maxSamples = equitySamples;
+        avg = equityToPrecision(p.hand, info.communityCards(), numOtherPlayers, target, rng).share;
+      }
+      //std::cout << "MATT SAYS: " << p.hand << " = " << matt << std::endl;
       PlayerMove myMove;
       if( avg < foldCallThres )
         myMove.move = Move::MOVE_FOLD;
@@ -320,18 +301,20 @@ namespace Poker {
 
 
       if( myMove.move == Move::MOVE_FOLD) myMove.bet_amount = 0;
-      else if( myMove.move == Move::MOVE_CALL) myMove.bet_amount = info->minimumBet;
-      else if( myMove.move == Move::MOVE_RAISE) myMove.bet_amount = info->minimumBet * 2;
-      else if( myMove.move == Move::MOVE_ALLIN) myMove.bet_amount = p->bankroll;
-      myMove.bet_amount = clamp(myMove.bet_amount, 0, p->bankroll);
-      if( myMove.bet_amount == p->bankroll) myMove.move = Move::MOVE_ALLIN;
+      else if( myMove.move == Move::MOVE_CALL) myMove.bet_amount = info.minimumBet();
+      else if( myMove.move == Move::MOVE_RAISE) myMove.bet_amount = info.minimumBet() * 2;
+      else if( myMove.move == Move::MOVE_ALLIN) myMove.bet_amount = p.bankroll;
+      myMove.bet_amount = clamp(myMove.bet_amount, 0, p.bankroll);
+      if( myMove.bet_amount == p.bankroll) myMove.move = Move::MOVE_ALLIN;
 
       return myMove;
 
     }
 
-    void MattAI::updateParametersImpl(std::vector<double> thresholds_in) {
-        thresholds = thresholds_in;
+    void MattAI::updateParameters(const std::vector<std::any>& params) {
+        if( params.empty() ) return;
+        thresholds.clear();
+        for(const std::any& t : params) thresholds.emplace_back(std::any_cast<double>(t));
     }
 
 
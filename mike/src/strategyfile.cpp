@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "strategyfile.h"
+#include "hash.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define POKER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define POKER_HAVE_MMAP 0
+#endif
+
+namespace Poker {
+  namespace {
+    constexpr char kMagic[4] = { 'C', 'F', 'R', 'P' };
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t numActions;
+        uint32_t entrySize;
+        uint64_t numEntries;
+        uint64_t checksum;          // of the entry bytes
+        uint64_t buckets;           // HandBuckets::fingerprint of the card abstraction the policy was trained with
+    };
+    static_assert(sizeof(FileHeader) % alignof(StrategyFile::Entry) == 0, "entries must stay aligned after the header");
+  }
+
+  bool StrategyFile::write(const std::string& path, const InfosetTable<kNumActions>& table, const uint64_t buckets) {
+      std::vector<Entry> sorted;
+      sorted.reserve(table.size());
+      table.forEach([&sorted](const uint64_t key, const std::array<float, kNumActions>& values) {
+          Entry e;
+          e.key = key;
+          std::copy(values.begin(), values.end(), e.values);
+          sorted.push_back(e);
+      });
+      std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+      FileHeader header;
+      std::memcpy(header.magic, kMagic, sizeof(kMagic));
+      header.version = kVersion;
+      header.numActions = kNumActions;
+      header.entrySize = sizeof(Entry);
+      header.numEntries = sorted.size();
+      header.checksum = fnv1a(sorted.data(), sorted.size() * sizeof(Entry));
+      header.buckets = buckets;
+
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      if( !out ) return false;
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char*>(sorted.data()), sorted.size() * sizeof(Entry));
+      return bool(out);
+  }
+
+  bool StrategyFile::open(const std::string& path, const bool verify) {
+      close();
+#if POKER_HAVE_MMAP
+      const int fd = ::open(path.c_str(), O_RDONLY);
+      if( fd < 0 ) return false;
+      struct stat st;
+      if( fstat(fd, &st) != 0 or static_cast<size_t>(st.st_size) < sizeof(FileHeader) ) {
+          ::close(fd);
+          return false;
+      }
+      void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);      // the mapping keeps the file alive
+      if( p == MAP_FAILED ) return false;
+      mapping = p;
+      mappingSize = st.st_size;
+#else
+      // No mmap: read the whole file into one buffer instead
+      std::ifstream in(path, std::ios::binary | std::ios::ate);
+      if( !in ) return false;
+      const size_t n = static_cast<size_t>(in.tellg());
+      if( n < sizeof(FileHeader) ) return false;
+      uint64_t* buffer = new uint64_t[(n + 7) / 8];
+      in.seekg(0);
+      if( !in.read(reinterpret_cast<char*>(buffer), n) ) {
+          delete[] buffer;
+          return false;
+      }
+      mapping = buffer;
+      mappingSize = n;
+#endif
+
+      // numEntries is bounded before it is multiplied, so a corrupt count can't wrap around and pass
+      const FileHeader* header = static_cast<const FileHeader*>(mapping);
+      const size_t room = (mappingSize - sizeof(FileHeader)) / sizeof(Entry);
+      const bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 and header->version == kVersion
+          and header->numActions == kNumActions and header->entrySize == sizeof(Entry)
+          and header->numEntries <= room and mappingSize == sizeof(FileHeader) + header->numEntries * sizeof(Entry);
+      if( !valid ) {
+          close();
+          return false;
+      }
+      entries = reinterpret_cast<const Entry*>(static_cast<const char*>(mapping) + sizeof(FileHeader));
+      numEntries = header->numEntries;
+      checksum = header->checksum;
+      buckets = header->buckets;
+      if( verify and !this->verify() ) {
+          close();
+          return false;
+      }
+      return true;
+  }
+
+  bool StrategyFile::verify() const {
+      return isOpen() and fnv1a(entries, numEntries * sizeof(Entry)) == checksum;
+  }
+
+  void StrategyFile::close() {
+      if( mapping ) {
+#if POKER_HAVE_MMAP
+          munmap(mapping, mappingSize);
+#else
+          delete[] static_cast<uint64_t*>(mapping);
+#endif
+      }
+      mapping = nullptr;
+      mappingSize = 0;
+      entries = nullptr;
+      numEntries = 0;
+      checksum = 0;
+      buckets = 0;
+  }
+
+  const StrategyFile::Entry* StrategyFile::find(const uint64_t key) const {
+      const Entry* it = std::lower_bound(begin(), end(), key, [](const Entry& e, const uint64_t k) { return e.key < k; });
+      return it != end() and it->key == key ? it : nullptr;
+  }
+
+}
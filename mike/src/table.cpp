@@ -4,19 +4,26 @@
 namespace Poker {
 
     std::shared_ptr<Deck>   Table::getDeck() { return std::make_shared<Deck>(deck); }
+    Table Table::clone() const {
+        // A plain copy shares its players with this table; the clone gets its own, so it can be played on another thread
+        Table t(*this);
+        for(shared_ptr<Player>& p : t.playerList) {
+            p = make_shared<Player>(*p);
+            if( p->strategy ) p->strategy = p->strategy->clone();
+        }
+        return t;
+    }
     void Table::dealCommunityCards(int street) {
         if( street == 1 ) {
             for(int i = 0; i < 3; i++ ) 
-                communityCards.push_back(deck.pop_card());
+                communityCards.insert(deck.pop_card(rng));
         }
-        else if (street > 1) { communityCards.push_back(deck.pop_card()); }
+        else if (street > 1) { communityCards.insert(deck.pop_card(rng)); }
     }
-    void Table::dealPlayersCards(const std::vector<shared_ptr<Player>> pList) {
+    void Table::dealPlayersCards(const std::vector<shared_ptr<Player>>& pList) {
         // Deals every active player two cards
-        for(shared_ptr<Player> p : pList) {
-            p->hand.clear();
-            p->hand.emplace_back(deck.pop_card());
-            p->hand.emplace_back(deck.pop_card());
+        for(const shared_ptr<Player>& p : pList) {
+            p->hand = deck.pop_cards(rng, 2);
         }
     }
     void Table::setPlayerList(const vector<string> sVec) {
@@ -36,6 +43,10 @@ namespace Poker {
                     guy->strategy = make_shared<CFRAI1>();
             else if (s == "Matt")
                     guy->strategy = make_shared<MattAI>();
+            else if (s == "ISMCTS")
+                    guy->strategy = make_shared<ISMCTSAI>();
+            else if (s == "external")
+                    guy->strategy = nullptr;            // decided outside the game, see Game::advanceToDecision
             else    throw;
             guy->setPosition(playerPositionList[n]);
             guy->playerID = n;
@@ -43,23 +54,19 @@ namespace Poker {
         }
     }
 
+    void Table::sortInBettingOrder(std::vector<shared_ptr<Player>>& players) const {
+        // sorts players into the correct (game) order in place
+        std::sort(players.begin(), players.end(), [](const shared_ptr<Player>& a, const shared_ptr<Player>& b) { return a->getPosition() < b->getPosition(); });
+    }
     std::vector<shared_ptr<Player>> Table::getPlayersInBettingOrder(std::vector<shared_ptr<Player>> pvector) {
         // returns a vector of pointers to players in the correct (game) order
-        auto comp = [](const shared_ptr<Player> a, const shared_ptr<Player> b) -> bool { return a->getPosition() < b->getPosition(); };
-        if( !pvector.empty() ) {
-            std::sort(pvector.begin(), pvector.end(), comp);
-            return pvector;
-        }
-        else {
-            vector<shared_ptr<Player>> ret (playerList);    // copy constructor
-            std::sort(ret.begin(), ret.end(), comp);
-            return ret;
-        }
-        return std::vector<shared_ptr<Player>>();
+        if( pvector.empty() ) pvector = playerList;
+        sortInBettingOrder(pvector);
+        return pvector;
     }
     void Table::clearPlayerHands() {
         // clears all player hands
-        for(auto P : this->playerList) {
+        for(const auto& P : this->playerList) {
             P->resetHand();
         }
     }
@@ -70,24 +77,20 @@ namespace Poker {
         }
     }
 
-    void Table::shuffleDeck() {
-        // Make sure deck has it's mersenne twister primed before calling this or you got a one-way ticket to segfault city
-        this->deck.shuffle();
-    }
-
-    void Table::resetCards(random_device& rd) {
-        // Resets all cards everywhere and gets a fresh RNG for the deck. 
-        std::mt19937_64 g(rd());
-        
-        deck = Deck();
-        // shuffle cards
-        std::shuffle(deck.cards.begin(), deck.cards.end(), g);
-        //this->shuffleDeck();
+    void Table::resetCards() {
+        // Resets all cards everywhere. The deck keeps drawing from the table's stream
+        // no shuffle needed, the deck shuffles as it deals
+        deck.reset();
         // clear community cards
         this->communityCards.clear();
         this->clearPlayerHands();       
     }
 
+    void Table::resetDeck(const CardSet& dead) {
+        // The deck keeps its order between deals; a duplicate replay needs it from the start
+        deck = Deck(dead);
+    }
+
     bool Table::arePlayerPositionsValid(const vector<shared_ptr<Player>>& pList) {
         // Returns true if each player in pList has a unique Position
         // Basically tells you if the Positions have been initialized correctly
@@ -99,7 +102,7 @@ namespace Poker {
         return uniquePositionPlayers.size() == pList.size();
     }
 
-    shared_ptr<Player> Table::getPlayerByID(const int& id) {
+    shared_ptr<Player> Table::getPlayerByID(const int& id) const {
         return *std::find_if(this->playerList.begin(), this->playerList.end(), [&id] (const shared_ptr<Player>& p) {return p->playerID == id;});
     };
 
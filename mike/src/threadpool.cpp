@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include "threadpool.h"
+
+namespace Poker {
+  namespace {
+    // Which pool started this thread and its queue there; outside threads share the last queue
+    thread_local const ThreadPool* workerPool = nullptr;
+    thread_local size_t workerIndex = 0;
+  }
+
+  thread_local int ThreadPool::chunkDepth = 0;
+
+  ThreadPool::ThreadPool(const unsigned numThreads) {
+      const unsigned numWorkers = numThreads > 1 ? numThreads - 1 : 0;
+      for(unsigned i = 0; i <= numWorkers; i++)
+          queues.emplace_back(std::make_unique<Queue>());
+      for(unsigned i = 0; i < numWorkers; i++)
+          workers.emplace_back([this, i]() { workerLoop(i); });
+  }
+
+  ThreadPool::~ThreadPool() {
+      {
+          std::lock_guard<std::mutex> guard(sleepLock);
+          stopping = true;
+      }
+      wake.notify_all();
+      for(std::thread& t : workers) t.join();
+  }
+
+  ThreadPool& ThreadPool::instance() {
+      static ThreadPool pool([]() -> unsigned {
+          if( const char* env = std::getenv("POKER_THREADS") ) {
+              const long n = std::strtol(env, nullptr, 10);
+              if( n > 0 ) return static_cast<unsigned>(n);
+          }
+          const unsigned hw = std::thread::hardware_concurrency();
+          return hw > 0 ? hw : 1;
+      }());
+      return pool;
+  }
+
+  size_t ThreadPool::homeQueue() const {
+      return workerPool == this ? workerIndex : workers.size();
+  }
+
+  void ThreadPool::push(std::function<void()> task) {
+      Queue& q = *queues[homeQueue()];
+      {
+          std::lock_guard<std::mutex> guard(q.lock);
+          q.tasks.emplace_back(std::move(task));
+      }
+      pending.fetch_add(1, std::memory_order_release);
+  }
+
+  void ThreadPool::notifyWorkers() {
+      // taking the lock orders this against a worker that has just seen pending == 0 and is about to sleep
+      { std::lock_guard<std::mutex> guard(sleepLock); }
+      wake.notify_all();
+  }
+
+  bool ThreadPool::runOne() {
+      // Newest task from our own queue first (its data is still in cache), then the oldest task of someone else
+      if( pending.load(std::memory_order_acquire) == 0 ) return false;
+      const size_t home = homeQueue();
+      std::function<void()> task;
+      for(size_t k = 0; k < queues.size() and !task; k++) {
+          Queue& q = *queues[(home + k) % queues.size()];
+          std::lock_guard<std::mutex> guard(q.lock);
+          if( q.tasks.empty() ) continue;
+          if( k == 0 ) {
+              task = std::move(q.tasks.back());
+              q.tasks.pop_back();
+          } else {
+              task = std::move(q.tasks.front());
+              q.tasks.pop_front();
+          }
+      }
+      if( !task ) return false;
+      pending.fetch_sub(1, std::memory_order_relaxed);
+      task();
+      return true;
+  }
+
+  void ThreadPool::workerLoop(const size_t index) {
+      workerPool = this;
+      workerIndex = index;
+      while( true ) {
+          if( runOne() ) continue;
+          std::unique_lock<std::mutex> guard(sleepLock);
+          wake.wait(guard, [this]() { return stopping or pending.load(std::memory_order_acquire) > 0; });
+          if( stopping ) return;
+      }
+  }
+
+}
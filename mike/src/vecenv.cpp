@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <stdexcept>
+#include "vecenv.h"
+#include "threadpool.h"
+
+namespace Poker {
+
+  VecEnv::VecEnv(const Settings& settings_in) : settings(settings_in) {
+      if( settings.numEnvs < 1 ) throw std::invalid_argument("VecEnv: numEnvs must be positive");
+      if( settings.opponents.empty() or settings.opponents.size() >= GameState::kMaxSeats )
+          throw std::invalid_argument("VecEnv: between 1 and 8 opponents");
+      if( std::count(settings.opponents.begin(), settings.opponents.end(), "external") )
+          throw std::invalid_argument("VecEnv: the agent is the only external player");
+      // With a stack bigger than the big blind the agent is never all-in on the blinds, so it acts in every hand
+      if( settings.stack <= settings.bigBlind ) throw std::invalid_argument("VecEnv: the stack must be bigger than the big blind");
+
+      std::vector<std::string> aiList = { "external" };      // the agent
+      aiList.insert(aiList.end(), settings.opponents.begin(), settings.opponents.end());
+      Poker::Table prototype;
+      prototype.setPlayerList(aiList);
+      prototype.bigBlind = settings.bigBlind;
+      prototype.smallBlind = settings.smallBlind;
+
+      Rng source(settings.seed);
+      envs.reserve(settings.numEnvs);
+      for(int i = 0; i < settings.numEnvs; i++) {
+          envs.push_back(Env { Game(prototype.clone()) });
+          envs.back().game.seed(source());
+      }
+      obs.resize(size_t(settings.numEnvs) * kObservationSize);
+      mask.resize(size_t(settings.numEnvs) * kNumActions);
+      reward.resize(settings.numEnvs);
+      done.resize(settings.numEnvs);
+      reset();
+  }
+
+  void VecEnv::reset() {
+      ThreadPool::instance().parallelFor(envs.size(), [this](const size_t i) {
+          reward[i] = 0.0f;
+          done[i] = 0;
+          startHand(i);
+          observe(i);
+      });
+  }
+
+  void VecEnv::step(const int32_t* actions) {
+      for(size_t i = 0; i < envs.size(); i++)
+          if( !legal(i, actions[i]) ) throw std::invalid_argument("VecEnv: illegal action " + std::to_string(actions[i]) + " at table " + std::to_string(i));
+
+      ThreadPool::instance().parallelFor(envs.size(), [this, actions](const size_t i) {
+          Game& game = envs[i].game;
+          const Player& agent = *game.bettingPlayers[game.seatToAct()];
+          game.applyMove(CFRAI1::unpackBinnedPlayerMove(static_cast<CFRAI1::BinnedPlayerMove>(actions[i]), game.state.minimumBet, agent.bankroll));
+          game.advanceToDecision();
+          reward[i] = 0.0f;
+          done[i] = 0;
+          if( game.state.over ) {
+              reward[i] = float(agent.bankroll - settings.stack) / settings.bigBlind;
+              done[i] = 1;
+              startHand(i);
+          }
+          observe(i);
+      });
+  }
+
+  void VecEnv::startHand(const size_t i) {
+      Env& env = envs[i];
+      Game& game = env.game;
+      const int n = game.table.playerList.size();
+      const std::vector<PlayerPosition>& positions = positionsInBettingOrder(n);
+      for(const shared_ptr<Player>& P : game.table.playerList)
+          P->setPosition(positions[(P->playerID + env.hands) % n]);
+      env.hands++;
+      game.table.setPlayerBankrolls(settings.stack);
+      game.setup();
+      game.startRound();
+      game.advanceToDecision();
+      if( game.state.over ) throw std::logic_error("VecEnv: a hand ended before the agent acted");
+  }
+
+  void VecEnv::observe(const size_t i) {
+      const Game& game = envs[i].game;
+      const GameState& state = game.state;
+      const float bb = settings.bigBlind;
+      const Game::Decision decision = game.pendingDecision();
+      const int me = decision.seat;
+      const Player& agent = *game.bettingPlayers[me];
+
+      float* o = obs.data() + i * kObservationSize;
+      std::fill(o, o + kObservationSize, 0.0f);
+      // card index (rank, suit lane 3 - suit) to card code
+      auto code = [](const int index) { return 4 * (index & 15) + 3 - (index >> 4); };
+      state.hole[me].forEachIndex([o, &code](int c) { o[code(c)] = 1.0f; });
+      state.board.forEachIndex([o, &code](int c) { o[52 + code(c)] = 1.0f; });
+      o[104 + state.street] = 1.0f;
+      o[108] = state.pot / bb;
+      o[109] = state.minimumBet / bb;
+      o[110] = std::max(0, state.minimumBet - state.contribution[me]) / bb;
+      o[111] = (agent.bankroll - state.contribution[me]) / bb;
+      o[112] = state.contribution[me] / bb;
+      for(int seat = 0; seat < state.numSeats; seat++) {
+          const Player& P = *game.bettingPlayers[seat];
+          float* f = o + 113 + kPerSeatFeatures * static_cast<int>(P.getPosition());
+          f[0] = 1.0f;
+          f[1] = seat == me;
+          f[2] = (state.status[seat] & GameState::kFolded) != 0;
+          f[3] = (state.status[seat] & GameState::kAllIn) != 0;
+          f[4] = state.contribution[seat] / bb;
+          f[5] = (P.bankroll - state.contribution[seat]) / bb;
+      }
+
+      // Folding and going all-in are always allowed; calling and raising need more chips than the bet
+      uint8_t* m = mask.data() + i * kNumActions;
+      m[static_cast<int>(CFRAI1::BinnedPlayerMove::Fold)] = 1;
+      m[static_cast<int>(CFRAI1::BinnedPlayerMove::Call)] = decision.canCall();
+      m[static_cast<int>(CFRAI1::BinnedPlayerMove::Raise)] = 2 * state.minimumBet < agent.bankroll;
+      m[static_cast<int>(CFRAI1::BinnedPlayerMove::AllIn)] = 1;
+  }
+
+}